@@ -0,0 +1,224 @@
+#ifndef GLIF_FLYWEIGHT_H
+#define GLIF_FLYWEIGHT_H
+
+// C++ includes:
+#include <cstddef>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace nest
+{
+
+/**
+ * Strict weak order for T::operator< of the values of a glif_flyweight, whose
+ * pool is a std::map. The built-in < leaves a NaN unordered against every
+ * double, which breaks the order of the map; here NaN comes after all other
+ * doubles and is equivalent to any NaN. Vectors are compared
+ * lexicographically, tuples (std::tie of the members) member by member and
+ * other types by their operator<.
+ */
+template < typename T >
+bool glif_flyweight_less( const T& a, const T& b );
+
+bool glif_flyweight_less( const double a, const double b );
+
+template < typename T >
+bool glif_flyweight_less( const std::vector< T >& a, const std::vector< T >& b );
+
+template < typename... Ts >
+bool glif_flyweight_less( const std::tuple< Ts... >& a, const std::tuple< Ts... >& b );
+
+template < typename T >
+inline bool
+glif_flyweight_less( const T& a, const T& b )
+{
+  return a < b;
+}
+
+inline bool
+glif_flyweight_less( const double a, const double b )
+{
+  return a < b or ( b != b and a == a );
+}
+
+template < typename T >
+inline bool
+glif_flyweight_less( const std::vector< T >& a, const std::vector< T >& b )
+{
+  for ( size_t i = 0; i < a.size() and i < b.size(); ++i )
+  {
+    if ( glif_flyweight_less( a[ i ], b[ i ] ) )
+    {
+      return true;
+    }
+    if ( glif_flyweight_less( b[ i ], a[ i ] ) )
+    {
+      return false;
+    }
+  }
+  return a.size() < b.size();
+}
+
+//! Order of the members of a tuple from member I on
+template < size_t I, typename Tuple, bool End = ( I == std::tuple_size< Tuple >::value ) >
+struct glif_flyweight_tuple_less
+{
+  static bool
+  less( const Tuple& a, const Tuple& b )
+  {
+    if ( glif_flyweight_less( std::get< I >( a ), std::get< I >( b ) ) )
+    {
+      return true;
+    }
+    if ( glif_flyweight_less( std::get< I >( b ), std::get< I >( a ) ) )
+    {
+      return false;
+    }
+    return glif_flyweight_tuple_less< I + 1, Tuple >::less( a, b );
+  }
+};
+
+template < size_t I, typename Tuple >
+struct glif_flyweight_tuple_less< I, Tuple, true >
+{
+  static bool
+  less( const Tuple&, const Tuple& )
+  {
+    return false;
+  }
+};
+
+template < typename... Ts >
+inline bool
+glif_flyweight_less( const std::tuple< Ts... >& a, const std::tuple< Ts... >& b )
+{
+  return glif_flyweight_tuple_less< 0, std::tuple< Ts... > >::less( a, b );
+}
+
+/**
+ * Shared, reference-counted and immutable value of type T. All flyweights
+ * holding equal values (by T::operator<) point to the same block, so that
+ * neurons replicated from a few hundred parameter sets store a single pointer
+ * each instead of their own copy with its vectors and strings.
+ *
+ * Assigning a value replaces the block the flyweight points to; the value of
+ * a block is never modified. Modify a copy and assign it back:
+ *
+ *   Parameters_ ptmp = *P_;
+ *   ptmp.set( d );
+ *   P_ = ptmp;
+ *
+ * Blocks are kept in one pool per type and freed with their last reference.
+ * Nodes are created and connected in parallel, so the pool is guarded by a
+ * critical section; reading a value does not lock.
+ */
+template < typename T >
+class glif_flyweight
+{
+public:
+  glif_flyweight()
+  {
+    acquire_( T() );
+  }
+
+  glif_flyweight( const T& value )
+  {
+    acquire_( value );
+  }
+
+  glif_flyweight( const glif_flyweight& f )
+    : entry_( f.entry_ )
+  {
+#pragma omp critical( glif_flyweight )
+    {
+      ++entry_->second;
+    }
+  }
+
+  ~glif_flyweight()
+  {
+    release_();
+  }
+
+  glif_flyweight& operator=( const glif_flyweight& f )
+  {
+    if ( entry_ != f.entry_ )
+    {
+      glif_flyweight tmp( f );
+      std::swap( entry_, tmp.entry_ );
+    }
+    return *this;
+  }
+
+  glif_flyweight& operator=( const T& value )
+  {
+    glif_flyweight tmp( value );
+    std::swap( entry_, tmp.entry_ );
+    return *this;
+  }
+
+  const T& operator*() const
+  {
+    return entry_->first;
+  }
+
+  const T* operator->() const
+  {
+    return &entry_->first;
+  }
+
+  //! Number of distinct values of type T currently in use
+  static size_t
+  pool_size()
+  {
+    size_t n = 0;
+#pragma omp critical( glif_flyweight )
+    {
+      n = pool_().size();
+    }
+    return n;
+  }
+
+private:
+  //! value and its reference count
+  typedef std::map< T, size_t > Pool_;
+
+  //! The pool is never destroyed, since static prototypes of the models may
+  //! release their blocks after static destructors of the module have run.
+  static Pool_&
+  pool_()
+  {
+    static Pool_* pool = new Pool_;
+    return *pool;
+  }
+
+  void
+  acquire_( const T& value )
+  {
+#pragma omp critical( glif_flyweight )
+    {
+      entry_ = pool_().insert( std::make_pair( value, size_t( 0 ) ) ).first;
+      ++entry_->second;
+    }
+  }
+
+  void
+  release_()
+  {
+#pragma omp critical( glif_flyweight )
+    {
+      if ( --entry_->second == 0 )
+      {
+        pool_().erase( entry_ );
+      }
+    }
+  }
+
+  typename Pool_::iterator entry_;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,108 @@
+#include "glif_gsl_workspace_pool.h"
+
+#ifdef HAVE_GSL
+
+nest::glif_gsl_workspace_pool nest::glif_gsl_workspace_pool::pool_;
+
+nest::glif_gsl_workspace_pool::~glif_gsl_workspace_pool()
+{
+  for ( size_t t = 0; t < workspaces_.size(); ++t )
+  {
+    for ( std::map< Key_, glif_gsl_workspace* >::iterator it = workspaces_[ t ].begin();
+          it != workspaces_[ t ].end();
+          ++it )
+    {
+      gsl_odeiv_step_free( it->second->s_ );
+      gsl_odeiv_control_free( it->second->c_ );
+      gsl_odeiv_evolve_free( it->second->e_ );
+      delete it->second;
+    }
+  }
+}
+
+nest::glif_gsl_workspace*
+nest::glif_gsl_workspace_pool::get( thread t, const gsl_odeiv_step_type* type, size_t dimension )
+{
+  glif_gsl_workspace* ws = 0;
+
+  // only called from calibrate(), so serializing the threads here is cheap
+  // and protects the resizing of the per-thread containers
+#pragma omp critical( glif_gsl_workspace_pool )
+  {
+    if ( pool_.workspaces_.size() <= static_cast< size_t >( t ) )
+    {
+      pool_.workspaces_.resize( t + 1 );
+    }
+
+    glif_gsl_workspace*& entry = pool_.workspaces_[ t ][ Key_( type, dimension ) ];
+    if ( entry == 0 )
+    {
+      entry = new glif_gsl_workspace;
+      entry->s_ = gsl_odeiv_step_alloc( type, dimension );
+      entry->c_ = gsl_odeiv_control_y_new( 1e-3, 0.0 );
+      entry->e_ = gsl_odeiv_evolve_alloc( dimension );
+      entry->shared_ = true;
+    }
+    ws = entry;
+  }
+
+  return ws;
+}
+
+bool
+nest::glif_gsl_workspace_pool::shareable( const gsl_odeiv_step_type* type )
+{
+  return type != gsl_odeiv_step_gear1 and type != gsl_odeiv_step_gear2;
+}
+
+nest::glif_gsl_own_workspace::glif_gsl_own_workspace()
+  : type_( 0 )
+  , dimension_( 0 )
+{
+}
+
+nest::glif_gsl_own_workspace::glif_gsl_own_workspace( const glif_gsl_own_workspace& )
+  : type_( 0 )
+  , dimension_( 0 )
+{
+}
+
+nest::glif_gsl_own_workspace::~glif_gsl_own_workspace()
+{
+  free_();
+}
+
+nest::glif_gsl_workspace*
+nest::glif_gsl_own_workspace::get( const gsl_odeiv_step_type* type, size_t dimension )
+{
+  if ( type != type_ or dimension != dimension_ )
+  {
+    free_();
+    ws_.s_ = gsl_odeiv_step_alloc( type, dimension );
+    ws_.c_ = gsl_odeiv_control_y_new( 1e-3, 0.0 );
+    ws_.e_ = gsl_odeiv_evolve_alloc( dimension );
+    ws_.shared_ = false;
+    type_ = type;
+    dimension_ = dimension;
+  }
+  else
+  {
+    gsl_odeiv_step_reset( ws_.s_ );
+    gsl_odeiv_evolve_reset( ws_.e_ );
+  }
+  return &ws_;
+}
+
+void
+nest::glif_gsl_own_workspace::free_()
+{
+  if ( type_ )
+  {
+    gsl_odeiv_step_free( ws_.s_ );
+    gsl_odeiv_control_free( ws_.c_ );
+    gsl_odeiv_evolve_free( ws_.e_ );
+    type_ = 0;
+  }
+}
+
+#endif // HAVE_GSL
@@ -0,0 +1,102 @@
+#ifndef GLIF_GSL_WORKSPACE_POOL_H
+#define GLIF_GSL_WORKSPACE_POOL_H
+
+// Generated includes:
+#include "config.h"
+
+#ifdef HAVE_GSL
+
+// C++ includes:
+#include <map>
+#include <utility>
+#include <vector>
+
+// C includes:
+#include <gsl/gsl_odeiv.h>
+
+#include "nest_types.h"
+
+namespace nest
+{
+
+/**
+ * GSL ODE workspaces for one stepping function and state vector dimension.
+ * For single-step methods they only hold scratch data of the integration
+ * step in progress, so all glif_*_cond neurons updated by the same thread
+ * can share them; the per-neuron state (state vector and adaptive step size)
+ * stays in the neuron.
+ */
+struct glif_gsl_workspace
+{
+  gsl_odeiv_step* s_;    //!< stepping function
+  gsl_odeiv_control* c_; //!< adaptive stepsize control function
+  gsl_odeiv_evolve* e_;  //!< evolution function
+  bool shared_;          //!< used by all neurons of a thread, see glif_gsl_workspace_pool
+};
+
+/**
+ * Pool of GSL ODE workspaces of the glif_*_cond models, holding one
+ * workspace per thread, stepping function and state vector dimension.
+ */
+class glif_gsl_workspace_pool
+{
+public:
+  ~glif_gsl_workspace_pool();
+
+  /**
+   * Returns the workspace of thread t for the given stepping function and
+   * state vector dimension and allocates it on first request. The workspace
+   * remains valid for the lifetime of the module, so neurons may keep a
+   * pointer to it between calibrate() and update().
+   */
+  static glif_gsl_workspace* get( thread t, const gsl_odeiv_step_type* type, size_t dimension );
+
+  /**
+   * Returns whether neurons may share the workspace of the stepping function.
+   * The multistep Gear methods keep the history of the last steps in their
+   * stepper, which a neuron sharing the workspace would have to reset at
+   * every update.
+   */
+  static bool shareable( const gsl_odeiv_step_type* type );
+
+private:
+  typedef std::pair< const gsl_odeiv_step_type*, size_t > Key_;
+
+  std::vector< std::map< Key_, glif_gsl_workspace* > > workspaces_; //!< workspaces per thread
+
+  static glif_gsl_workspace_pool pool_;
+};
+
+/**
+ * GSL ODE workspace owned by a single neuron, for the stepping functions
+ * that glif_gsl_workspace_pool does not share. Copies of a neuron start
+ * without a workspace.
+ */
+class glif_gsl_own_workspace
+{
+public:
+  glif_gsl_own_workspace();
+  glif_gsl_own_workspace( const glif_gsl_own_workspace& );
+  ~glif_gsl_own_workspace();
+
+  /**
+   * Returns the workspace for the given stepping function and state vector
+   * dimension, allocated on first request or when they changed, and clears
+   * its stepper history, which does not carry over into a new simulation.
+   */
+  glif_gsl_workspace* get( const gsl_odeiv_step_type* type, size_t dimension );
+
+private:
+  glif_gsl_own_workspace& operator=( const glif_gsl_own_workspace& );
+
+  void free_();
+
+  glif_gsl_workspace ws_;
+  const gsl_odeiv_step_type* type_; //!< stepping function of ws_, 0 if not allocated
+  size_t dimension_;                //!< state vector dimension of ws_
+};
+
+} // namespace
+
+#endif // HAVE_GSL
+#endif
@@ -1,14 +1,7 @@
 #ifndef GLIF_LIF_H
 #define GLIF_LIF_H
 
-#include "archiving_node.h"
-#include "connection.h"
-#include "event.h"
-#include "nest_types.h"
-#include "ring_buffer.h"
-#include "universal_data_logger.h"
-
-#include "dictdatum.h"
+#include "glif_neuron.h"
 
 /* BeginDocumentation
 Name: glif_lif - Generalized leaky integrate and fire (GLIF) model 1 -
@@ -19,6 +12,11 @@ Description:
   glif_lif is an implementation of a generalized leaky integrate and fire (GLIF)
   model 1, i.e., traditional leaky integrate and fire (LIF) model, described in [1].
 
+  If the input current is constant over a min_delay slice and V_m cannot reach
+  the threshold within it, the slice is crossed in a single closed-form step.
+  The recorded samples are then filled in from the closed form, which is only
+  done if a multimeter is connected.
+
 Parameters:
 
   The following parameters can be set in the status dictionary.
@@ -32,7 +30,30 @@ Parameters:
   V_reset           double - Reset potential of the membrane in mV.
   V_dynamics_method string - Voltage dynamics (Equation (1) in [1]) solution methods:
                              'linear_forward_euler' - Linear Euler forward (RK1) to find next V_m value, or
-                             'linear_exact' - Linear exact to find next V_m value.
+                             'linear_rk2' - Linear second-order Runge-Kutta (Heun) to find next V_m value, or
+                             'linear_exact' - Linear exact to find next V_m value, or
+                             'linear_exact_event_driven' - Linear exact, but V_m is only updated
+                             step by step at input changes, threshold crossings and during the
+                             refractory period and is propagated in closed form in between, or
+                             'matrix_exponential' - Exact propagation of V_m together with the after-spike
+                             currents, the voltage component of the threshold and the synaptic currents,
+                             instead of holding the after-spike currents constant over a step.
+  quiescence_tol    double - Tolerance in mV and pA within which the neuron is considered to rest at
+                             equilibrium (V_m at E_L, all other state variables at zero). While at
+                             rest without input the neuron skips its dynamics. 0.0 (default) requires
+                             the exact equilibrium; with a positive tolerance the state is snapped
+                             onto the equilibrium once within the tolerance.
+  spike_time_method string - Location of the threshold crossing within a step, the spike time:
+                             'linear' - Linear interpolation of V_m and the threshold (default), or
+                             'hermite' - Cubic Hermite interpolation of V_m less the threshold, or
+                             'exact' - Root finding on the solution of the voltage dynamics method
+                             within the step.
+                             'hermite' and 'exact' also detect crossings after which V_m falls below
+                             the threshold again before the end of the step, which 'linear' misses;
+                             they disable the closed form of 'linear_exact_event_driven'.
+  integration_substeps long - Number of integration steps per simulation step (default 1). The
+                             dynamics are integrated with the resolution divided by it, while input,
+                             spike delivery and recording stay on the grid of the resolution.
 
 References:
   [1] Teeter C, Iyer R, Menon V, Gouwens N, Feng D, Berg J, Szafer A,
@@ -43,188 +64,14 @@ References:
 Author: Binghuang Cai and Kael Dai @ Allen Institute for Brain Science
 */
 
-namespace nest {
-
-class glif_lif : public nest::Archiving_Node {
-public:
-  glif_lif();
-
-  glif_lif(const glif_lif &);
-
-  using nest::Node::handle;
-  using nest::Node::handles_test_event;
-
-  nest::port send_test_event(nest::Node &, nest::port, nest::synindex, bool);
-
-  void handle(nest::SpikeEvent &);
-  void handle(nest::CurrentEvent &);
-  void handle(nest::DataLoggingRequest &);
-
-  nest::port handles_test_event(nest::SpikeEvent &, nest::port);
-  nest::port handles_test_event(nest::CurrentEvent &, nest::port);
-  nest::port handles_test_event(nest::DataLoggingRequest &, nest::port);
-
-  bool is_off_grid() const // uses off_grid events
-  {
-    return true;
-  }
-
-  void get_status(DictionaryDatum &) const;
-  void set_status(const DictionaryDatum &);
-
-private:
-  //! Reset parameters and state of neuron.
-
-  //! Reset state of neuron.
-  void init_state_(const Node &proto);
-
-  //! Reset internal buffers of neuron.
-  void init_buffers_();
-
-  //! Initialize auxiliary quantities, leave parameters and state untouched.
-  void calibrate();
-
-  //! Take neuron through given time interval
-  void update(nest::Time const &, const long, const long);
-
-  // The next two classes need to be friends to access the State_ class/member
-  friend class nest::RecordablesMap<glif_lif>;
-  friend class nest::UniversalDataLogger<glif_lif>;
-
-  struct Parameters_ {
-    double th_inf_;                 // A constant spiking threshold in mV
-    double G_;                      // membrane conductance in nS
-    double E_L_;                    // resting potential in mV
-    double C_m_;                    // capacitance in pF
-    double t_ref_;                  // refractory time in ms
-    double V_reset_;                // Membrane voltage following spike in mV
-    std::string V_dynamics_method_; // voltage dynamic methods
-
-    Parameters_();
-
-    void get(DictionaryDatum &) const;
-    void set(const DictionaryDatum &);
-  };
-
-  struct State_ {
-    double V_m_; // membrane potential in mV
-    double I_;   // external current in pA
-
-    State_();
-
-    void get(DictionaryDatum &) const;
-    void set(const DictionaryDatum &, const Parameters_ &);
-  };
-
-  struct Buffers_ {
-    Buffers_(glif_lif &);
-    Buffers_(const Buffers_ &, glif_lif &);
-
-    nest::RingBuffer spikes_; //!< Buffer incoming spikes through delay, as sum
-    nest::RingBuffer currents_; //!< Buffer incoming currents through delay,
-
-    //! Logger for all analog data
-    nest::UniversalDataLogger<glif_lif> logger_;
-  };
-
-  struct Variables_ {
-    double t_ref_remaining_; // counter during refractory period, seconds
-    double t_ref_total_;     // total time of refractory period, seconds
-    int method_; // voltage dynamics solver method flag: 0-linear forward euler;
-                 // 1-linear exact
-  };
-
-  double get_V_m_() const { return S_.V_m_; }
-
-  Parameters_ P_; //!< Free parameters.
-  State_ S_;      //!< Dynamic state.
-  Variables_ V_;  //!< Internal Variables
-  Buffers_ B_;    //!< Buffers.
-
-  //! Mapping of recordables names to access functions
-  static nest::RecordablesMap<glif_lif> recordablesMap_;
-};
-
-inline nest::port nest::glif_lif::send_test_event(nest::Node &target,
-                                                   nest::port receptor_type,
-                                                   nest::synindex, bool) {
-  // You should usually not change the code in this function.
-  // It confirms that the target of connection @c c accepts @c SpikeEvent on
-  // the given @c receptor_type.
-  nest::SpikeEvent e;
-  e.set_sender(*this);
-  return target.handles_test_event(e, receptor_type);
-}
-
-inline nest::port
-nest::glif_lif::handles_test_event(nest::SpikeEvent &,
-                                    nest::port receptor_type) {
-  // You should usually not change the code in this function.
-  // It confirms to the connection management system that we are able
-  // to handle @c SpikeEvent on port 0. You need to extend the function
-  // if you want to differentiate between input ports.
-  if (receptor_type != 0){
-    throw nest::UnknownReceptorType(receptor_type, get_name());
-  }
-  return 0;
-}
-
-inline nest::port
-nest::glif_lif::handles_test_event(nest::CurrentEvent &,
-                                    nest::port receptor_type) {
-  // You should usually not change the code in this function.
-  // It confirms to the connection management system that we are able
-  // to handle @c CurrentEvent on port 0. You need to extend the function
-  // if you want to differentiate between input ports.
-  if (receptor_type != 0){
-    throw nest::UnknownReceptorType(receptor_type, get_name());
-  }
-  return 0;
-}
-
-inline nest::port
-nest::glif_lif::handles_test_event(nest::DataLoggingRequest &dlr,
-                                    nest::port receptor_type) {
-  // You should usually not change the code in this function.
-  // It confirms to the connection management system that we are able
-  // to handle @c DataLoggingRequest on port 0.
-  // The function also tells the built-in UniversalDataLogger that this node
-  // is recorded from and that it thus needs to collect data during simulation.
-  if (receptor_type != 0){
-    throw nest::UnknownReceptorType(receptor_type, get_name());
-  }
-
-  return B_.logger_.connect_logging_device(dlr, recordablesMap_);
-}
-
-inline void glif_lif::get_status(DictionaryDatum &d) const {
-  // get our own parameter and state data
-  P_.get(d);
-  S_.get(d);
-
-  // get information managed by parent class
-  Archiving_Node::get_status(d);
-
-  (*d)[nest::names::recordables] = recordablesMap_.get_list();
-}
-
-inline void glif_lif::set_status(const DictionaryDatum &d) {
-  Parameters_ ptmp = P_; // temporary copy in case of errors
-  ptmp.set(d);           // throws if BadProperty
-  State_ stmp = S_;      // temporary copy in case of errors
-  stmp.set(d, ptmp);     // throws if BadProperty
+namespace nest
+{
 
-  // We now know that (ptmp, stmp) are consistent. We do not
-  // write them back to (P_, S_) before we are also sure that
-  // the properties to be set in the parent class are internally
-  // consistent.
-  Archiving_Node::set_status(d);
+typedef glif_neuron< glif_fixed_reset, glif_no_asc, glif_no_voltage_threshold, glif_current_input > glif_lif;
 
-  // if we get here, temporaries contain consistent set of properties
-  P_ = ptmp;
-  S_ = stmp;
-}
+template <>
+void RecordablesMap< glif_lif >::create();
 
-} // namespace
+} // namespace nest
 
 #endif
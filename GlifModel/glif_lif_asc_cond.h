@@ -20,6 +20,13 @@
 
 #include "dictdatum.h"
 
+#include "glif_active_receptors.h"
+#include "glif_flyweight.h"
+#include "glif_small_vector.h"
+
+#include "glif_gsl_workspace_pool.h"
+#include "glif_receptor_classes.h"
+
 /* BeginDocumentation
 Name: glif_lif_asc_cond - Generalized leaky integrate and fire (GLIF) model 3 -
                           Leaky integrate and fire with after-spike currents model.
@@ -51,10 +58,50 @@ Parameters:
   asc_amps          double vector - After-spike current amplitudes in pA (deltaIj in Equation (7) in [1]).
   r                 double vector - Current fraction following spike coefficients (fj in Equation (7) in [1]).
   tau_syn           double vector - Rise time constants of the synaptic alpha function in ms.
+                             Ports with equal tau_syn and E_rev share one synaptic conductance, which
+                             receives the spikes of all of them; the state g and dg holds one entry per
+                             port, the shared conductance of its ports.
   E_rev             double vector - Reversal potential in mV.
   V_dynamics_method string - Voltage dynamics (Equation (1) in [1]) solution methods:
-                             'linear_forward_euler' - Linear Euler forward (RK1) to find next V_m value, or
-                             'linear_exact' - Linear exact to find next V_m value.
+                             'gsl_rkf45' - Adaptive GSL integration (stepping function given by solver) of V_m and
+                                           the synaptic conductances, or
+                             'exponential_integrator' - Closed-form propagation of the synaptic conductances
+                                           and exponential integration of V_m with the step-averaged
+                                           conductances (no GSL calls).
+                             With both methods the after-spike currents are propagated exactly and enter
+                             the V_m dynamics with their value at the beginning of each time step.
+  solver            string - GSL stepping function of the 'gsl_rkf45' method:
+                             'rkf45' - Explicit embedded Runge-Kutta-Fehlberg (4, 5) (default),
+                             'rk2imp' - Implicit 2nd order Runge-Kutta at Gaussian points,
+                             'rk4imp' - Implicit 4th order Runge-Kutta at Gaussian points,
+                             'bsimp' - Implicit Bulirsch-Stoer method of Bader and Deuflhard, or
+                             'gear2' - Implicit 2nd order multistep Gear (BDF) method.
+                             The implicit stepping functions keep large steps under strong synaptic
+                             conductances (stiff system); 'bsimp' uses the analytic Jacobian.
+                             The stepper of the other functions is shared by the neurons of a thread and
+                             restarts at each time slice (min_delay); 'gear2' has a stepper per neuron,
+                             whose multistep history only restarts at each Simulate.
+  gsl_abs_tol       double - Absolute error tolerance of the adaptive GSL integration (default 1e-3).
+  gsl_rel_tol       double - Relative error tolerance of the adaptive GSL integration (default 0.0).
+  gsl_initial_step  double - Initial integration step size of the GSL integration in ms, bounded by the
+                             resolution (default 0.01).
+  gsl_min_step      double - Lower bound of the trial integration step size in ms (default 0.0).
+  gsl_max_step      double - Upper bound of the integration step size in ms (default inf).
+  refractory_closed_form bool - If true, the 'gsl_rkf45' method skips the GSL integration while the
+                             neuron is refractory (V_m is clamped) and propagates only the synaptic
+                             conductances in closed form (default false); results change within
+                             the GSL error tolerance. The 'exponential_integrator' method always skips
+                             V_m while refractory, which leaves its results bit-identical.
+  quiescence_tol    double - Tolerance in mV, pA and nS within which the neuron is considered to rest at
+                             equilibrium (V_m at E_L, all other state variables at zero). While at
+                             rest without input the neuron skips its dynamics. 0.0 (default) requires
+                             the exact equilibrium; with a positive tolerance the state is snapped
+                             onto the equilibrium once within the tolerance.
+  receptor_tol      double - Synaptic conductance in nS within which a receptor port is inactive. Ports are
+                             only propagated while active, from a spike arriving at them until their
+                             conductance has decayed to within the tolerance and is set to zero. The
+                             default, the smallest normal double, drops ports before their decay
+                             reaches subnormal values, which are slow to compute.
 
 References:
   [1] Teeter C, Iyer R, Menon V, Gouwens N, Feng D, Berg J, Szafer A,
@@ -72,6 +119,7 @@ namespace nest
 {
 
 extern "C" int glif_lif_asc_cond_dynamics( double, const double*, double*, void* );
+extern "C" int glif_lif_asc_cond_jacobian( double, const double*, double*, double*, void* );
 
 class glif_lif_asc_cond : public nest::Archiving_Node
 {
@@ -119,8 +167,16 @@ private:
   //! Take neuron through given time interval
   void update( nest::Time const&, const long, const long );
 
-  // make dynamics function quasi-member
+  //! Check whether the neuron rests at equilibrium without input, see quiescence_tol
+  bool is_quiescent_();
+
+  //! Whether receptor port i stays active; otherwise its conductance has
+  //! decayed to within receptor_tol of zero and is set to zero
+  bool receptor_active_( const size_t i );
+
+  // make dynamics function and its Jacobian quasi-member
   friend int glif_lif_asc_cond_dynamics( double, const double*, double*, void* );
+  friend int glif_lif_asc_cond_jacobian( double, const double*, double*, double*, void* );
 
   // The next two classes need to be friends to access the State_ class/member
   friend class nest::RecordablesMap< glif_lif_asc_cond >;
@@ -142,6 +198,16 @@ private:
     std::vector<double> r_; // coefficient
     std::vector< double > tau_syn_; // synaptic port time constants in ms
     std::vector< double > E_rev_; // reversal pontiental in mV
+    std::string V_dynamics_method_; // voltage dynamic methods
+    std::string solver_; // GSL stepping function of the gsl_rkf45 method
+    double abs_tol_; // absolute error tolerance of GSL integration
+    double rel_tol_; // relative error tolerance of GSL integration
+    double initial_step_; // initial GSL integration step size in ms
+    double min_step_; // lower bound of GSL integration step size in ms
+    double max_step_; // upper bound of GSL integration step size in ms
+    bool refractory_closed_form_; // skip GSL integration while refractory
+    double quiescence_tol_; // tolerance of the detection of rest at equilibrium
+    double receptor_tol_; // conductance in nS within which a decayed receptor port is inactive
 
     // boolean flag which indicates whether the neuron has connections
     bool has_connections_;
@@ -153,19 +219,23 @@ private:
 
     void get( DictionaryDatum& ) const;
     void set( const DictionaryDatum& );
+
+    //! Order of all members, used to share equal parameter sets
+    bool operator<( const Parameters_& ) const;
   };
 
 
   struct State_
   {
+    // fields used in every step come first, next to each other in memory
     double V_m_; // membrane potential in mV
     double ASCurrents_sum_; // in pA
+    double t_ref_remaining_; // counter during refractory period, in ms
 
     //! Symbolic indices to the elements of the state vector y
     enum StateVecElems
     {
       V_M = 0,
-      ASC,
       DG_SYN,
       G_SYN,
       STATE_VECTOR_MIN_SIZE
@@ -175,12 +245,14 @@ private:
     static const size_t NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR = 2; // DG_SYN, G_SYN
 
     std::vector< double > y_; //!< neuron state
+    glif_active_receptors active_receptors_; //!< receptor ports with synaptic conductances
+    glif_small_vector< double, 2 > ASCurrents_; //!< after-spike currents in pA, propagated exactly outside of y_
 
     State_( const Parameters_& );
     State_( const State_& );
     State_& operator=( const State_& );
 
-    void get( DictionaryDatum&, const Parameters_&) const;
+    void get( DictionaryDatum&, const Parameters_&, const std::vector< size_t >& receptor_class ) const;
     void set( const DictionaryDatum&, const Parameters_& );
   };
 
@@ -197,9 +269,8 @@ private:
     nest::UniversalDataLogger< glif_lif_asc_cond > logger_;
 
     /* GSL ODE stuff */
-    gsl_odeiv_step* s_;    //!< stepping function
-    gsl_odeiv_control* c_; //!< adaptive stepsize control function
-    gsl_odeiv_evolve* e_;  //!< evolution function
+    glif_gsl_workspace* gsl_ws_; //!< GSL workspaces, shared by the neurons of this thread or own_gsl_ws_
+    glif_gsl_own_workspace own_gsl_ws_; //!< GSL workspaces of this neuron, for stepping functions not shared
     gsl_odeiv_system sys_; //!< struct describing system
 
     // IntergrationStep_ should be reset with the neuron on ResetNetwork,
@@ -222,14 +293,28 @@ private:
 
   struct Variables_
   {
-    double t_ref_remaining_; // counter during refractory period, in ms
     double t_ref_total_; // total time of refractory period, in ms
+    int method_; // voltage dynamics solver method flag: 0-gsl rkf45; 1-exponential integrator
+    const gsl_odeiv_step_type* step_type_; // GSL stepping function selected by solver
+    bool refractory_closed_form_; // V_m is not integrated while refractory
 
     /** Amplitude of the synaptic conductance.
         This value is chosen such that an event of weight 1.0 results in a peak conductance of 1 nS
         at t = tau_syn.
     */
-    std::vector< double > CondInitialValues_;
+    glif_small_vector< double, 4 > CondInitialValues_;
+
+    std::vector< size_t > receptor_class_; // class of each receptor port, see glif_receptor_classes
+    std::vector< size_t > class_port_;     // first receptor port of each class
+    glif_small_vector< double, 4 > tau_syn_; // synaptic time constant of each class in ms
+    glif_small_vector< double, 4 > E_rev_;   // reversal potential of each class in mV
+
+    glif_small_vector< double, 4 > P11_; // synaptic conductance evolution parameter
+    glif_small_vector< double, 4 > P21_; // synaptic conductance evolution parameter
+    glif_small_vector< double, 4 > P22_; // synaptic conductance evolution parameter
+    glif_small_vector< double, 4 > PA1_; // step-averaged synaptic conductance parameter
+    glif_small_vector< double, 4 > PA2_; // step-averaged synaptic conductance parameter
+    glif_small_vector< double, 2 > P_asc_; // after-spike current evolution parameter
 
     unsigned int receptor_types_size_;
   };
@@ -243,7 +328,7 @@ private:
     return S_.y_[ elem ];
   }
 
-  Parameters_ P_;
+  glif_flyweight< Parameters_ > P_; //!< Free parameters, shared by equal sets.
   State_ S_;
   Variables_ V_;
   Buffers_ B_;
@@ -300,8 +385,8 @@ inline void
 glif_lif_asc_cond::get_status( DictionaryDatum& d) const
 {
   // get our own parameter and state data
-  P_.get( d );
-  S_.get( d, P_ );
+  P_->get( d );
+  S_.get( d, *P_, V_.receptor_class_ );
 
   // get information managed by parent class
   Archiving_Node::get_status( d );
@@ -312,7 +397,7 @@ glif_lif_asc_cond::get_status( DictionaryDatum& d) const
 inline void
 glif_lif_asc_cond::set_status( const DictionaryDatum& d )
 {
-  Parameters_ ptmp = P_; // temporary copy in case of errors
+  Parameters_ ptmp = *P_; // temporary copy in case of errors
   ptmp.set( d );         // throws if BadProperty
   State_ stmp = S_;      // temporary copy in case of errors
   stmp.set( d, ptmp );   // throws if BadProperty
@@ -1,14 +1,7 @@
 #ifndef GLIF_LIF_ASC_PSC_H
 #define GLIF_LIF_ASC_PSC_H
 
-#include "archiving_node.h"
-#include "connection.h"
-#include "event.h"
-#include "nest_types.h"
-#include "ring_buffer.h"
-#include "universal_data_logger.h"
-
-#include "dictdatum.h"
+#include "glif_neuron.h"
 
 /* BeginDocumentation
 Name: glif_lif_asc_psc - Generalized leaky integrate and fire (GLIF) model 3 -
@@ -41,9 +34,35 @@ Parameters:
   asc_amps          double vector - After-spike current amplitudes in pA (deltaIj in Equation (7) in [1]).
   r                 double vector - Current fraction following spike coefficients (fj in Equation (7) in [1]).
   tau_syn           double vector - Rise time constants of the synaptic alpha function in ms.
+                             Ports with equal tau_syn share one synaptic current, which receives the
+                             spikes of all of them.
   V_dynamics_method string - Voltage dynamics (Equation (1) in [1]) solution methods:
                              'linear_forward_euler' - Linear Euler forward (RK1) to find next V_m value, or
-                             'linear_exact' - Linear exact to find next V_m value.
+                             'linear_rk2' - Linear second-order Runge-Kutta (Heun) to find next V_m value, or
+                             'linear_exact' - Linear exact to find next V_m value, or
+                             'matrix_exponential' - Exact propagation of V_m together with the after-spike
+                             currents, the voltage component of the threshold and the synaptic currents,
+                             instead of holding the after-spike currents constant over a step.
+  quiescence_tol    double - Tolerance in mV and pA within which the neuron is considered to rest at
+                             equilibrium (V_m at E_L, all other state variables at zero). While at
+                             rest without input the neuron skips its dynamics. 0.0 (default) requires
+                             the exact equilibrium; with a positive tolerance the state is snapped
+                             onto the equilibrium once within the tolerance.
+  receptor_tol      double - Synaptic current in pA within which a receptor port is inactive. Ports are
+                             only propagated while active, from a spike arriving at them until their
+                             current has decayed to within the tolerance and is set to zero. The
+                             default, the smallest normal double, drops ports before their decay
+                             reaches subnormal values, which are slow to compute.
+  spike_time_method string - Location of the threshold crossing within a step, the spike time:
+                             'linear' - Linear interpolation of V_m and the threshold (default), or
+                             'hermite' - Cubic Hermite interpolation of V_m less the threshold, or
+                             'exact' - Root finding on the solution of the voltage dynamics method
+                             within the step.
+                             'hermite' and 'exact' also detect crossings after which V_m falls below
+                             the threshold again before the end of the step, which 'linear' misses.
+  integration_substeps long - Number of integration steps per simulation step (default 1). The
+                             dynamics are integrated with the resolution divided by it, while input,
+                             spike delivery and recording stay on the grid of the resolution.
 
 References:
   [1] Teeter C, Iyer R, Menon V, Gouwens N, Feng D, Berg J, Szafer A,
@@ -57,223 +76,10 @@ Author: Binghuang Cai and Kael Dai @ Allen Institute for Brain Science
 namespace nest
 {
 
-class glif_lif_asc_psc : public nest::Archiving_Node
-{
-public:
-
-  glif_lif_asc_psc();
-
-  glif_lif_asc_psc( const glif_lif_asc_psc& );
-
-  using nest::Node::handle;
-  using nest::Node::handles_test_event;
-
-  nest::port send_test_event( nest::Node&, nest::port, nest::synindex, bool );
-
-  void handle( nest::SpikeEvent& );
-  void handle( nest::CurrentEvent& );
-  void handle( nest::DataLoggingRequest& );
-
-  nest::port handles_test_event( nest::SpikeEvent&, nest::port );
-  nest::port handles_test_event( nest::CurrentEvent&, nest::port );
-  nest::port handles_test_event( nest::DataLoggingRequest&, nest::port );
-
-  bool is_off_grid() const  // uses off_grid events
-  {
-    return true;
-  }
-
-  void get_status( DictionaryDatum& ) const;
-  void set_status( const DictionaryDatum& );
-
-private:
-  //! Reset parameters and state of neuron.
-
-  //! Reset state of neuron.
-  void init_state_( const Node& proto );
-
-  //! Reset internal buffers of neuron.
-  void init_buffers_();
-
-  //! Initialize auxiliary quantities, leave parameters and state untouched.
-  void calibrate();
-
-  //! Take neuron through given time interval
-  void update( nest::Time const&, const long, const long );
-
-  // The next two classes need to be friends to access the State_ class/member
-  friend class nest::RecordablesMap< glif_lif_asc_psc >;
-  friend class nest::UniversalDataLogger< glif_lif_asc_psc >;
-
-
-  struct Parameters_
-  {
-    double V_th_; // A constant spiking threshold in mV
-    double G_; // membrane conductance in nS
-    double E_L_; // resting potential in mV
-    double C_m_; // capacitance in pF
-    double t_ref_; // refractory time in ms
-    double V_reset_; // Membrane voltage following spike in mV
-
-    std::vector<double> asc_init_; // initial values of ASCurrents_ in pA
-    std::vector<double> k_; // predefined time scale in 1/ms
-    std::vector<double> asc_amps_; // in pA
-    std::vector<double> r_; // coefficient
-    std::vector< double > tau_syn_; // synaptic port time constants in ms
-    std::string V_dynamics_method_; // voltage dynamic methods
-
-    // boolean flag which indicates whether the neuron has connections
-    bool has_connections_;
-
-    size_t n_receptors_() const; //!< Returns the size of tau_syn_
-
-    Parameters_();
-
-    void get( DictionaryDatum& ) const;
-    void set( const DictionaryDatum& );
-  };
-
-
-  struct State_
-  {
-    double V_m_; // membrane potential in mV
-    std::vector<double> ASCurrents_; // after-spike currents in pA
-    double ASCurrents_sum_; // in pA
-
-    double I_; // external current in pA
-    double I_syn_; // post synaptic current in pA
-    std::vector< double > y1_; // synapse current evolution state 1 in pA
-    std::vector< double > y2_; // synapse current evolution state 2 in pA
-
-    State_();
-
-    void get( DictionaryDatum& ) const;
-    void set( const DictionaryDatum&, const Parameters_& );
-  };
-
-
-  struct Buffers_
-  {
-    Buffers_( glif_lif_asc_psc& );
-    Buffers_( const Buffers_&, glif_lif_asc_psc& );
-
-    std::vector< nest::RingBuffer > spikes_; //!< Buffer incoming spikes through delay, as sum
-    nest::RingBuffer currents_; //!< Buffer incoming currents through delay,
-
-    //! Logger for all analog data
-    nest::UniversalDataLogger< glif_lif_asc_psc > logger_;
-  };
-
-  struct Variables_
-  {
-    double t_ref_remaining_; // counter during refractory period, in ms
-    double t_ref_total_; // total time of refractory period, in ms
-    int method_; // voltage dynamics solver method flag: 0-linear forward euler; 1-linear exact
-    std::vector< double > P11_; // synaptic current evolution parameter
-    std::vector< double > P21_; // synaptic current evolution parameter
-    std::vector< double > P22_; // synaptic current evolution parameter
-    double P30_; // membrane current/voltage evolution parameter
-    double P33_; // membrane voltage evolution parameter
-    std::vector< double > P31_; // synaptic/membrane current evolution parameter
-    std::vector< double > P32_; // synaptic/membrane current evolution parameter
-
-    /** Amplitude of the synaptic current.
-              This value is chosen such that a post-synaptic current with
-              weight one has an amplitude of 1 pA.
-    */
-    std::vector< double > PSCInitialValues_;
-
-    unsigned int receptor_types_size_;
-  };
-
-  double get_V_m_() const
-  {
-    return S_.V_m_;
-  }
-
-  double get_AScurrents_sum_() const
-  {
-    return S_.ASCurrents_[0];
-  }
-
-  double get_I_syn_() const
-  {
-    return S_.I_syn_;
-  }
-
-  Parameters_ P_;
-  State_ S_;
-  Variables_ V_;
-  Buffers_ B_;
-
-  // Mapping of recordables names to access functions
-  static nest::RecordablesMap< glif_lif_asc_psc > recordablesMap_;
-};
-
-inline size_t
-nest::glif_lif_asc_psc::Parameters_::n_receptors_() const
-{
-  return tau_syn_.size();
-}
-
-inline nest::port
-nest::glif_lif_asc_psc::send_test_event( nest::Node& target,
-  nest::port receptor_type,
-  nest::synindex,
-  bool )
-{
-  nest::SpikeEvent e;
-  e.set_sender( *this );
-  return target.handles_test_event( e, receptor_type );
-}
-
-inline nest::port
-nest::glif_lif_asc_psc::handles_test_event( nest::CurrentEvent&,
-  nest::port receptor_type )
-{
-  if ( receptor_type != 0 ){
-    throw nest::UnknownReceptorType( receptor_type, get_name() );
-  }
-  return 0;
-}
-
-inline nest::port
-nest::glif_lif_asc_psc::handles_test_event( nest::DataLoggingRequest& dlr,
-  nest::port receptor_type )
-{
-  if ( receptor_type != 0 ){
-    throw nest::UnknownReceptorType( receptor_type, get_name() );
-  }
-  return B_.logger_.connect_logging_device( dlr, recordablesMap_ );
-}
-
-inline void
-glif_lif_asc_psc::get_status( DictionaryDatum& d ) const
-{
-  // get our own parameter and state data
-  P_.get( d );
-  S_.get( d );
-
-  // get information managed by parent class
-  Archiving_Node::get_status( d );
-
-  ( *d )[ nest::names::recordables ] = recordablesMap_.get_list();
-}
-
-inline void
-glif_lif_asc_psc::set_status( const DictionaryDatum& d )
-{
-  Parameters_ ptmp = P_; // temporary copy in case of errors
-  ptmp.set( d );         // throws if BadProperty
-  State_ stmp = S_;      // temporary copy in case of errors
-  stmp.set( d, ptmp );   // throws if BadProperty
-
-  Archiving_Node::set_status( d );
+typedef glif_neuron< glif_fixed_reset, glif_asc, glif_no_voltage_threshold, glif_alpha_psc > glif_lif_asc_psc;
 
-  // if we get here, temporaries contain consistent set of properties
-  P_ = ptmp;
-  S_ = stmp;
-}
+template <>
+void RecordablesMap< glif_lif_asc_psc >::create();
 
 } // namespace nest
 
@@ -0,0 +1,20 @@
+#include "glif_lif_asc_psc_ps.h"
+
+#include "glif_neuron_ps_impl.h"
+
+namespace nest
+{
+// Override the create() method with one call to RecordablesMap::insert_()
+// for each quantity to be recorded.
+template <>
+void
+RecordablesMap< glif_lif_asc_psc_ps >::create()
+{
+  insert_( names::V_m, &glif_lif_asc_psc_ps::get_V_m_ );
+  insert_( Name( "AScurrents_sum" ), &glif_lif_asc_psc_ps::get_AScurrents_sum_ );
+  insert_( names::I_syn, &glif_lif_asc_psc_ps::get_I_syn_ );
+}
+
+template class glif_neuron_ps< glif_fixed_reset, glif_asc, glif_no_voltage_threshold, glif_alpha_psc >;
+
+} // namespace nest
@@ -1,7 +1,10 @@
 #include "glif_lif_cond.h"
 
 // C++ includes:
+#include <cmath>
+#include <algorithm>
 #include <limits>
+#include <tuple>
 #include <iostream>
 
 // Includes from libnestutil:
@@ -63,24 +66,73 @@ nest::glif_lif_cond_dynamics( double,
   // good compiler will optimize the verbosity away ...
 
   double I_syn = 0.0;
-  for ( size_t i = 0; i < node.P_.n_receptors_(); ++i )
+  for ( size_t k = 0; k < node.S_.active_receptors_.size(); ++k )
   {
+    const size_t i = node.S_.active_receptors_[ k ];
     const size_t j = i * S::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR;
-    I_syn += y[ S::G_SYN + j ] * ( y[ S::V_M] - node.P_.E_rev_[ i ] );
+    I_syn += y[ S::G_SYN + j ] * ( y[ S::V_M] - node.V_.E_rev_[ i ] );
   }
 
-  const double I_leak = node.P_.G_ * ( y[ S::V_M ] - node.P_.E_L_ );
+  const double I_leak = node.P_->G_ * ( y[ S::V_M ] - node.P_->E_L_ );
 
   // dV_m/dt
-  f[ 0 ] = ( -I_leak - I_syn  + node.B_.I_stim_ ) / node.P_.C_m_;
+  f[ 0 ] = ( -I_leak - I_syn  + node.B_.I_stim_ ) / node.P_->C_m_;
 
-  // d dg_exc/dt, dg_exc/dt
-  for ( size_t i = 0; i < node.P_.n_receptors_(); ++i )
+  // d dg_exc/dt, dg_exc/dt of the active ports; the conductances of the
+  // others stay zero
+  std::fill( f + S::DG_SYN, f + node.B_.sys_.dimension, 0.0 );
+  for ( size_t k = 0; k < node.S_.active_receptors_.size(); ++k )
   {
+    const size_t i = node.S_.active_receptors_[ k ];
     const size_t j = i * S::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR;
     // Synaptic conductance derivative dG/dt
-    f[ S::DG_SYN + j ] = -y[ S::DG_SYN + j ] / node.P_.tau_syn_[ i ];
-    f[ S::G_SYN + j ] = y[ S::DG_SYN + j ] - (y[ S::G_SYN + j ] / node.P_.tau_syn_[ i ]);
+    f[ S::DG_SYN + j ] = -y[ S::DG_SYN + j ] / node.V_.tau_syn_[ i ];
+    f[ S::G_SYN + j ] = y[ S::DG_SYN + j ] - (y[ S::G_SYN + j ] / node.V_.tau_syn_[ i ]);
+  }
+
+  return GSL_SUCCESS;
+}
+
+
+extern "C" inline int
+nest::glif_lif_cond_jacobian( double,
+  const double y[],
+  double* dfdy,
+  double dfdt[],
+  void* pnode )
+{
+  // a shorthand
+  typedef nest::glif_lif_cond::State_ S;
+
+  // get access to node so we can almost work as in a member function
+  assert( pnode );
+  const nest::glif_lif_cond& node =
+    *( reinterpret_cast< nest::glif_lif_cond* >( pnode ) );
+
+  // dfdy is the Jacobian matrix in row-major order,
+  // dfdy[ r * dim + c ] = d f[ r ] / d y[ c ]; the system is autonomous,
+  // so all time derivatives dfdt vanish
+  const size_t dim = node.B_.sys_.dimension;
+  std::fill( dfdy, dfdy + dim * dim, 0.0 );
+  std::fill( dfdt, dfdt + dim, 0.0 );
+
+  // d(dV_m/dt)/dV_m and d(dV_m/dt)/dg_syn
+  double g_tot = node.P_->G_;
+  for ( size_t i = 0; i < node.V_.class_port_.size(); ++i )
+  {
+    const size_t j = i * S::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR;
+    g_tot += y[ S::G_SYN + j ];
+    dfdy[ S::G_SYN + j ] = -( y[ S::V_M ] - node.V_.E_rev_[ i ] ) / node.P_->C_m_;
+  }
+  dfdy[ S::V_M ] = -g_tot / node.P_->C_m_;
+
+  // d(d dg/dt)/d dg, d(dg/dt)/d dg, d(dg/dt)/dg
+  for ( size_t i = 0; i < node.V_.class_port_.size(); ++i )
+  {
+    const size_t j = i * S::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR;
+    dfdy[ ( S::DG_SYN + j ) * dim + S::DG_SYN + j ] = -1.0 / node.V_.tau_syn_[ i ];
+    dfdy[ ( S::G_SYN + j ) * dim + S::DG_SYN + j ] = 1.0;
+    dfdy[ ( S::G_SYN + j ) * dim + S::G_SYN + j ] = -1.0 / node.V_.tau_syn_[ i ];
   }
 
   return GSL_SUCCESS;
@@ -99,13 +151,24 @@ nest::glif_lif_cond::Parameters_::Parameters_()
   , V_reset_(-77.4) // mV
   , tau_syn_(1, 2.0) // ms
   , E_rev_(1, -70.0) // mV
+  , V_dynamics_method_("gsl_rkf45")
+  , solver_("rkf45")
+  , abs_tol_(1e-3)
+  , rel_tol_(0.0)
+  , initial_step_(0.01) // in ms
+  , min_step_(0.0) // in ms
+  , max_step_(std::numeric_limits< double >::infinity()) // in ms
+  , refractory_closed_form_(false)
+  , quiescence_tol_(0.0)
+  , receptor_tol_( std::numeric_limits< double >::min() ) // in nS
   , has_connections_( false )
 
 {
 }
 
 nest::glif_lif_cond::State_::State_( const Parameters_& p )
-  : y_( STATE_VECTOR_MIN_SIZE, 0.0 )
+  : t_ref_remaining_(0.0) // in ms
+  , y_( STATE_VECTOR_MIN_SIZE, 0.0 )
 
 {
     y_[ V_M ] = p.E_L_; // initialize to membrane potential
@@ -114,7 +177,9 @@ nest::glif_lif_cond::State_::State_( const Parameters_& p )
 nest::glif_lif_cond::State_::State_( const State_& s )
 
 {
+  t_ref_remaining_ = s.t_ref_remaining_;
   y_ = s.y_;
+  active_receptors_ = s.active_receptors_;
 }
 
 nest::glif_lif_cond::State_& nest::glif_lif_cond::State_::operator=(
@@ -126,7 +191,9 @@ nest::glif_lif_cond::State_& nest::glif_lif_cond::State_::operator=(
     return *this;
   }
 
+  t_ref_remaining_ = s.t_ref_remaining_;
   y_ = s.y_;
+  active_receptors_ = s.active_receptors_;
 
   return *this;
 }
@@ -149,6 +216,16 @@ nest::glif_lif_cond::Parameters_::get( DictionaryDatum& d ) const
   def< ArrayDatum >( d, names::tau_syn, tau_syn_ad );
   ArrayDatum E_rev_ad( E_rev_ );
   def< ArrayDatum >( d, names::E_rev, E_rev_ad );
+  def<std::string>(d, "V_dynamics_method", V_dynamics_method_);
+  def<std::string>(d, "solver", solver_);
+  def<double>(d, "gsl_abs_tol", abs_tol_);
+  def<double>(d, "gsl_rel_tol", rel_tol_);
+  def<double>(d, "gsl_initial_step", initial_step_);
+  def<double>(d, "gsl_min_step", min_step_);
+  def<double>(d, "gsl_max_step", max_step_);
+  def<bool>(d, "refractory_closed_form", refractory_closed_form_);
+  def<double>(d, "quiescence_tol", quiescence_tol_);
+  def<double>(d, "receptor_tol", receptor_tol_);
   def< bool >( d, names::has_connections, has_connections_ );
 
 }
@@ -162,12 +239,63 @@ nest::glif_lif_cond::Parameters_::set( const DictionaryDatum& d )
   updateValue< double >(d, names::C_m, C_m_ );
   updateValue< double >(d, names::t_ref, t_ref_ );
   updateValue< double >(d, names::V_reset, V_reset_ );
+  updateValue< std::string >(d, "V_dynamics_method", V_dynamics_method_);
+  updateValue< std::string >(d, "solver", solver_);
+  updateValue< double >(d, "gsl_abs_tol", abs_tol_ );
+  updateValue< double >(d, "gsl_rel_tol", rel_tol_ );
+  updateValue< double >(d, "gsl_initial_step", initial_step_ );
+  updateValue< double >(d, "gsl_min_step", min_step_ );
+  updateValue< double >(d, "gsl_max_step", max_step_ );
+  updateValue< bool >(d, "refractory_closed_form", refractory_closed_form_ );
+  updateValue< double >(d, "quiescence_tol", quiescence_tol_ );
+  updateValue< double >(d, "receptor_tol", receptor_tol_ );
 
   if ( V_reset_ >= th_inf_ )
   {
     throw BadProperty( "Reset potential must be smaller than threshold." );
   }
 
+  if ( V_dynamics_method_ != "gsl_rkf45" && V_dynamics_method_ != "exponential_integrator" )
+  {
+    throw BadProperty(
+      "V_dynamics_method must be one of 'gsl_rkf45' or 'exponential_integrator'." );
+  }
+
+  if ( solver_ != "rkf45" && solver_ != "rk2imp" && solver_ != "rk4imp"
+       && solver_ != "bsimp" && solver_ != "gear2" )
+  {
+    throw BadProperty(
+      "Solver must be one of 'rkf45', 'rk2imp', 'rk4imp', 'bsimp' or 'gear2'." );
+  }
+
+  if ( abs_tol_ < 0.0 || rel_tol_ < 0.0 || ( abs_tol_ == 0.0 && rel_tol_ == 0.0 ) )
+  {
+    throw BadProperty(
+      "The GSL error tolerances must be non-negative and not both zero." );
+  }
+
+  if ( initial_step_ <= 0.0 || max_step_ <= 0.0 )
+  {
+    throw BadProperty(
+      "The initial and maximal GSL integration step sizes must be strictly positive." );
+  }
+
+  if ( min_step_ < 0.0 || min_step_ > max_step_ )
+  {
+    throw BadProperty(
+      "The minimal GSL integration step size must be non-negative and not larger than the maximal one." );
+  }
+
+  if ( quiescence_tol_ < 0.0 )
+  {
+    throw BadProperty( "Quiescence tolerance must be non-negative." );
+  }
+
+  if ( receptor_tol_ < 0.0 )
+  {
+    throw BadProperty( "Receptor tolerance must be non-negative." );
+  }
+
   if ( C_m_ <= 0.0 )
   {
     throw BadProperty( "Capacitance must be strictly positive." );
@@ -222,23 +350,33 @@ nest::glif_lif_cond::Parameters_::set( const DictionaryDatum& d )
 
 }
 
+bool
+nest::glif_lif_cond::Parameters_::operator<( const Parameters_& p ) const
+{
+  return glif_flyweight_less(
+    std::tie( th_inf_, G_, E_L_, C_m_, t_ref_, V_reset_, tau_syn_, E_rev_, V_dynamics_method_, solver_,
+      abs_tol_, rel_tol_, initial_step_, min_step_, max_step_, refractory_closed_form_, quiescence_tol_,
+      receptor_tol_, has_connections_ ),
+    std::tie( p.th_inf_, p.G_, p.E_L_, p.C_m_, p.t_ref_, p.V_reset_, p.tau_syn_, p.E_rev_,
+      p.V_dynamics_method_, p.solver_, p.abs_tol_, p.rel_tol_, p.initial_step_, p.min_step_, p.max_step_,
+      p.refractory_closed_form_, p.quiescence_tol_, p.receptor_tol_, p.has_connections_ ) );
+}
+
 void
-nest::glif_lif_cond::State_::get( DictionaryDatum& d ) const
+nest::glif_lif_cond::State_::get( DictionaryDatum& d,
+  const std::vector< size_t >& receptor_class ) const
 {
   def< double >(d, names::V_m, y_[V_M] );
 
   std::vector< double >* dg = new std::vector< double >();
   std::vector< double >* g = new std::vector< double >();
 
-  for ( size_t i = 0;
-        i < ( ( y_.size() - State_::NUMBER_OF_FIXED_STATES_ELEMENTS )
-              / State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR );
-        ++i )
+  // one entry per receptor port, the conductance of the class it shares
+  for ( size_t i = 0; i < receptor_class.size(); ++i )
   {
-    dg->push_back( y_[ State_::DG_SYN
-      + ( State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR * i ) ] );
-    g->push_back( y_[ State_::G_SYN
-      + ( State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR * i ) ] );
+    const size_t j = receptor_class[ i ] * State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR;
+    dg->push_back( y_[ State_::DG_SYN + j ] );
+    g->push_back( y_[ State_::G_SYN + j ] );
   }
 
   ( *d )[ names::dg ] = DoubleVectorDatum( dg );
@@ -257,9 +395,7 @@ nest::glif_lif_cond::State_::set( const DictionaryDatum& d,
 
 nest::glif_lif_cond::Buffers_::Buffers_( glif_lif_cond& n )
   : logger_( n )
-  , s_( 0 )
-  , c_( 0 )
-  , e_( 0 )
+  , gsl_ws_( 0 )
   , step_( Time::get_resolution().get_ms() )
   , IntegrationStep_( std::min( 0.01, step_ ) )
   , I_stim_( 0.0 )
@@ -268,9 +404,7 @@ nest::glif_lif_cond::Buffers_::Buffers_( glif_lif_cond& n )
 
 nest::glif_lif_cond::Buffers_::Buffers_( const Buffers_& b, glif_lif_cond& n )
   : logger_( n )
-  , s_( 0 )
-  , c_( 0 )
-  , e_( 0 )
+  , gsl_ws_( 0 )
   , step_( b.step_ )
   , IntegrationStep_( b.IntegrationStep_ )
   , I_stim_( b.I_stim_ )
@@ -285,7 +419,7 @@ nest::glif_lif_cond::Buffers_::Buffers_( const Buffers_& b, glif_lif_cond& n )
 nest::glif_lif_cond::glif_lif_cond()
   : Archiving_Node()
   , P_()
-  , S_( P_ )
+  , S_( *P_ )
   , B_( *this )
 {
   recordablesMap_.create();
@@ -301,19 +435,7 @@ nest::glif_lif_cond::glif_lif_cond( const glif_lif_cond& n )
 
 nest::glif_lif_cond::~glif_lif_cond()
 {
-  // GSL structs may not have been allocated, so we need to protect destruction
-  if ( B_.s_ )
-  {
-    gsl_odeiv_step_free( B_.s_ );
-  }
-  if ( B_.c_ )
-  {
-    gsl_odeiv_control_free( B_.c_ );
-  }
-  if ( B_.e_ )
-  {
-    gsl_odeiv_evolve_free( B_.e_ );
-  }
+  // GSL workspaces are owned by glif_gsl_workspace_pool
 }
 
 /* ----------------------------------------------------------------
@@ -336,19 +458,10 @@ nest::glif_lif_cond::init_buffers_()
 
   B_.step_ = Time::get_resolution().get_ms();
   // We must integrate this model with high-precision to obtain decent results
-  B_.IntegrationStep_ = std::min( 0.01, B_.step_ );
-
-  if ( B_.c_ == 0 )
-  {
-    B_.c_ = gsl_odeiv_control_y_new( 1e-3, 0.0 );
-  }
-  else
-  {
-    gsl_odeiv_control_init( B_.c_, 1e-3, 0.0, 1.0, 0.0 );
-  }
+  B_.IntegrationStep_ = std::min( P_->initial_step_, B_.step_ );
 
   B_.sys_.function = glif_lif_cond_dynamics;
-  B_.sys_.jacobian = NULL;
+  B_.sys_.jacobian = glif_lif_cond_jacobian;
   B_.sys_.params = reinterpret_cast< void* >( this );
 
   B_.I_stim_ = 0.0;
@@ -359,45 +472,173 @@ nest::glif_lif_cond::calibrate()
 {
   B_.logger_.init();
 
-  V_.t_ref_remaining_ = 0.0;
-  V_.t_ref_total_ = P_.t_ref_; //in ms
+  S_.t_ref_remaining_ = 0.0;
+  V_.t_ref_total_ = P_->t_ref_; //in ms
+
+  // receptor ports of equal tau_syn and E_rev share one synaptic conductance
+  const std::vector< size_t > receptor_class = V_.receptor_class_;
+  glif_receptor_classes( P_->tau_syn_, P_->E_rev_, V_.receptor_class_, V_.class_port_ );
+
+  // the conductance of a class holds the sum over its ports, which cannot be
+  // split among other classes after tau_syn or E_rev changed; it is reset
+  // and the spikes pending for the old classes are discarded
+  const bool new_classes = V_.receptor_class_ != receptor_class;
+  if ( new_classes )
+  {
+    S_.y_.resize( State_::NUMBER_OF_FIXED_STATES_ELEMENTS );
+  }
+  V_.tau_syn_.resize( V_.class_port_.size() );
+  V_.E_rev_.resize( V_.class_port_.size() );
+  for ( size_t i = 0; i < V_.class_port_.size(); ++i )
+  {
+    V_.tau_syn_[ i ] = P_->tau_syn_[ V_.class_port_[ i ] ];
+    V_.E_rev_[ i ] = P_->E_rev_[ V_.class_port_[ i ] ];
+  }
 
-  V_.CondInitialValues_.resize( P_.n_receptors_() );
+  V_.CondInitialValues_.resize( V_.class_port_.size() );
 
-  B_.spikes_.resize( P_.n_receptors_() );
+  B_.spikes_.resize( V_.class_port_.size() );
 
   S_.y_.resize( State_::NUMBER_OF_FIXED_STATES_ELEMENTS
-      + ( State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR * P_.n_receptors_() ),
+      + ( State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR * V_.class_port_.size() ),
     0.0 );
 
-  for (size_t i = 0; i < P_.n_receptors_() ; i++ )
+  S_.active_receptors_.clear();
+  for ( size_t i = 0; i < V_.class_port_.size(); ++i )
   {
-    V_.CondInitialValues_[i] = 1.0 * numerics::e / P_.tau_syn_[i];
-    B_.spikes_[ i ].resize();
+    const size_t j = i * State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR;
+    if ( S_.y_[ State_::DG_SYN + j ] != 0.0 || S_.y_[ State_::G_SYN + j ] != 0.0 )
+    {
+      S_.active_receptors_.insert( i );
+    }
+  }
+
+  V_.method_ = 0; // default using GSL rkf45 for the full ODE system
+  if(P_->V_dynamics_method_=="exponential_integrator"){
+     V_.method_ = 1;
   }
 
-  // reallocate instance of stepping function for ODE GSL solver
-  if ( B_.s_ != 0 )
+  // the membrane potential is clamped while refractory, so its integration
+  // can be skipped; this does not change the results of the exponential integrator
+  V_.refractory_closed_form_ = V_.method_ == 1 || P_->refractory_closed_form_;
+
+  // GSL stepping function of the gsl_rkf45 method
+  V_.step_type_ = gsl_odeiv_step_rkf45;
+  if ( P_->solver_ == "rk2imp" )
+  {
+    V_.step_type_ = gsl_odeiv_step_rk2imp;
+  }
+  else if ( P_->solver_ == "rk4imp" )
   {
-    gsl_odeiv_step_free( B_.s_ );
+    V_.step_type_ = gsl_odeiv_step_rk4imp;
   }
-  B_.s_ = gsl_odeiv_step_alloc( gsl_odeiv_step_rkf45, S_.y_.size() );
+  else if ( P_->solver_ == "bsimp" )
+  {
+    V_.step_type_ = gsl_odeiv_step_bsimp;
+  }
+  else if ( P_->solver_ == "gear2" )
+  {
+    V_.step_type_ = gsl_odeiv_step_gear2;
+  }
+
+  // propagators of the exponential integrator
+  const double h = Time::get_resolution().get_ms(); // in ms
 
-  // reallocate instance of evolution function for ODE GSL solver
-  if ( B_.e_ != 0 )
+  V_.P11_.resize( V_.class_port_.size() );
+  V_.P21_.resize( V_.class_port_.size() );
+  V_.P22_.resize( V_.class_port_.size() );
+  V_.PA1_.resize( V_.class_port_.size() );
+  V_.PA2_.resize( V_.class_port_.size() );
+
+  for (size_t i = 0; i < V_.class_port_.size() ; i++ )
   {
-    gsl_odeiv_evolve_free( B_.e_ );
+    V_.CondInitialValues_[i] = 1.0 * numerics::e / V_.tau_syn_[i];
+    if ( new_classes )
+    {
+      B_.spikes_[ i ].clear();
+    }
+    else
+    {
+      B_.spikes_[ i ].resize();
+    }
+
+    // exact solution of the alpha conductance over one step,
+    // g(t+h) = (g(t) + h * dg(t)) * exp(-h/tau_syn), dg(t+h) = dg(t) * exp(-h/tau_syn)
+    V_.P11_[i] = V_.P22_[i] = std::exp( -h / V_.tau_syn_[i] );
+    V_.P21_[i] = h * V_.P11_[i];
+
+    // mean of g over the step, (1/h) * int_0^h g(t+s) ds = PA1 * dg(t) + PA2 * g(t)
+    V_.PA2_[i] = -V_.tau_syn_[i] * numerics::expm1( -h / V_.tau_syn_[i] ) / h;
+    V_.PA1_[i] = V_.tau_syn_[i] * ( V_.PA2_[i] - V_.P11_[i] );
   }
-  B_.e_ = gsl_odeiv_evolve_alloc( S_.y_.size() );
 
   B_.sys_.dimension = S_.y_.size();
 
+  // the exponential integrator does not need any GSL workspace
+  if ( V_.method_ == 0 )
+  {
+    // The GSL workspaces are shared by all neurons of this thread with the
+    // same stepping function and size of the state vector, except those of
+    // gear2, whose multistep history stays in a workspace of the neuron; the
+    // adaptive step size B_.IntegrationStep_ stays with the neuron and
+    // carries over across Simulate() calls.
+    B_.gsl_ws_ = glif_gsl_workspace_pool::shareable( V_.step_type_ )
+      ? glif_gsl_workspace_pool::get( get_thread(), V_.step_type_, S_.y_.size() )
+      : B_.own_gsl_ws_.get( V_.step_type_, S_.y_.size() );
+  }
 }
 
 /* ----------------------------------------------------------------
  * Update and spike handling functions
  * ---------------------------------------------------------------- */
 
+bool
+nest::glif_lif_cond::is_quiescent_()
+{
+  // the neuron must neither be refractory nor receive input, and it must
+  // not spike at its resting potential
+  if ( S_.t_ref_remaining_ > 0.0 || B_.I_stim_ != 0.0 || P_->E_L_ >= P_->th_inf_
+       || std::abs( S_.y_[ State_::V_M ] - P_->E_L_ ) > P_->quiescence_tol_ )
+  {
+    return false;
+  }
+  for ( size_t k = 0; k < S_.active_receptors_.size(); ++k )
+  {
+    const size_t j = S_.active_receptors_[ k ] * State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR;
+    if ( std::abs( S_.y_[ State_::DG_SYN + j ] ) > P_->quiescence_tol_
+         || std::abs( S_.y_[ State_::G_SYN + j ] ) > P_->quiescence_tol_ )
+    {
+      return false;
+    }
+  }
+
+  // snap the state onto the equilibrium, which then does not change
+  S_.y_[ State_::V_M ] = P_->E_L_;
+  for ( size_t i = 0; i < V_.class_port_.size(); ++i )
+  {
+    const size_t j = i * State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR;
+    S_.y_[ State_::DG_SYN + j ] = 0.0;
+    S_.y_[ State_::G_SYN + j ] = 0.0;
+  }
+  S_.active_receptors_.clear();
+
+  return true;
+}
+
+bool
+nest::glif_lif_cond::receptor_active_( const size_t i )
+{
+  const size_t j = i * State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR;
+  if ( std::abs( S_.y_[ State_::DG_SYN + j ] ) > P_->receptor_tol_
+       || std::abs( S_.y_[ State_::G_SYN + j ] ) > P_->receptor_tol_ )
+  {
+    return true;
+  }
+  S_.y_[ State_::DG_SYN + j ] = 0.0;
+  S_.y_[ State_::G_SYN + j ] = 0.0;
+  return false;
+}
+
 void
 nest::glif_lif_cond::update( Time const& origin, const long from, const long to )
 {
@@ -405,45 +646,140 @@ nest::glif_lif_cond::update( Time const& origin, const long from, const long to
   const double dt = Time::get_resolution().get_ms(); // in ms
   double v_old = S_.y_[ State_::V_M ];
 
+  if ( V_.method_ == 0 )
+  {
+    // shared workspaces may have been used by another neuron of this thread,
+    // so drop its stepper history and apply the tolerances of this neuron
+    if ( B_.gsl_ws_->shared_ )
+    {
+      gsl_odeiv_step_reset( B_.gsl_ws_->s_ );
+    }
+    gsl_odeiv_control_init( B_.gsl_ws_->c_, P_->abs_tol_, P_->rel_tol_, 1.0, 0.0 );
+  }
+
   for ( long lag = from; lag < to; ++lag )
   {
-    double t = 0.0;
-    // numerical integration with adaptive step size control:
-    // ------------------------------------------------------
-    // gsl_odeiv_evolve_apply performs only a single numerical
-    // integration step, starting from t and bounded by step;
-    // the while-loop ensures integration over the whole simulation
-    // step (0, step] if more than one integration step is needed due
-    // to a small integration step size;
-    // note that (t+IntegrationStep > step) leads to integration over
-    // (t, step] and afterwards setting t to step, but it does not
-    // enforce setting IntegrationStep to step-t; this is of advantage
-    // for a consistent and efficient integration across subsequent
-    // simulation intervals
-    while ( t < B_.step_ )
+    // quiescence fast path: at rest and without input the state does not
+    // change, so that only the input buffers are read and the state recorded
+    if ( is_quiescent_() )
+    {
+      for( size_t i = 0; i < V_.class_port_.size(); i++ )
+      {
+        const double weight = B_.spikes_[ i ].get_value( lag );
+        if ( weight != 0.0 )
+        {
+          S_.y_[ State_::DG_SYN + ( State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR * i ) ] +=
+            weight * V_.CondInitialValues_[i];
+          S_.active_receptors_.insert( i );
+        }
+      }
+      B_.I_stim_ = B_.currents_.get_value( lag );
+      B_.logger_.record_data( origin.get_steps() + lag );
+      v_old = S_.y_[ State_::V_M ];
+      continue;
+    }
+
+    if ( S_.t_ref_remaining_ > 0.0 && V_.refractory_closed_form_ )
+    {
+      // V_m is clamped while refractory, so only the synaptic conductances
+      // are propagated with their exact solutions
+      for ( size_t k = 0; k < S_.active_receptors_.size(); ++k )
+      {
+        const size_t i = S_.active_receptors_[ k ];
+        const size_t j = i * State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR;
+        S_.y_[ State_::G_SYN + j ] = V_.P21_[i] * S_.y_[ State_::DG_SYN + j ] + V_.P22_[i] * S_.y_[ State_::G_SYN + j ];
+        S_.y_[ State_::DG_SYN + j ] *= V_.P11_[i];
+      }
+    }
+    else
+    {
+      switch(V_.method_){
+        // Adaptive integration of the full system with GSL, by default Runge-Kutta-Fehlberg (4, 5)
+        case 0:
+        {
+          double t = 0.0;
+          // numerical integration with adaptive step size control:
+          // ------------------------------------------------------
+          // gsl_odeiv_evolve_apply performs only a single numerical
+          // integration step, starting from t and bounded by step;
+          // the while-loop ensures integration over the whole simulation
+          // step (0, step] if more than one integration step is needed due
+          // to a small integration step size;
+          // note that (t+IntegrationStep > step) leads to integration over
+          // (t, step] and afterwards setting t to step, but it does not
+          // enforce setting IntegrationStep to step-t; this is of advantage
+          // for a consistent and efficient integration across subsequent
+          // simulation intervals
+          while ( t < B_.step_ )
+          {
+            // keep the trial integration step size within the configured bounds
+            B_.IntegrationStep_ = std::min( std::max( B_.IntegrationStep_, P_->min_step_ ), P_->max_step_ );
+
+            const int status = gsl_odeiv_evolve_apply( B_.gsl_ws_->e_,
+              B_.gsl_ws_->c_,
+              B_.gsl_ws_->s_,
+              &B_.sys_,             // system of ODE
+              &t,                   // from t
+              B_.step_,             // to t <= step
+              &B_.IntegrationStep_, // integration step size
+              &S_.y_[0] );               // neuronal state
+            if ( status != GSL_SUCCESS )
+            {
+              throw GSLSolverFailure( get_name(), status );
+            }
+          }
+        }
+          break;
+        // Exponential integrator without GSL
+        case 1:
+        {
+          // Exponential integration: the alpha conductances are propagated
+          // exactly and enter the membrane equation through their mean over
+          // the step, with which V_m relaxes exponentially towards the
+          // conductance-weighted reversal potential.
+          double g_tot = P_->G_; // in nS
+          double I_0 = P_->G_ * P_->E_L_ + B_.I_stim_; // in pA
+          for ( size_t k = 0; k < S_.active_receptors_.size(); ++k )
+          {
+            const size_t i = S_.active_receptors_[ k ];
+            const size_t j = i * State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR;
+            const double g_mean = V_.PA1_[i] * S_.y_[ State_::DG_SYN + j ] + V_.PA2_[i] * S_.y_[ State_::G_SYN + j ];
+            g_tot += g_mean;
+            I_0 += g_mean * V_.E_rev_[i];
+
+            S_.y_[ State_::G_SYN + j ] = V_.P21_[i] * S_.y_[ State_::DG_SYN + j ] + V_.P22_[i] * S_.y_[ State_::G_SYN + j ];
+            S_.y_[ State_::DG_SYN + j ] *= V_.P11_[i];
+          }
+
+          // V(t+h) = V(t) + (I_0 - g_tot * V(t)) / g_tot * (1 - exp(-g_tot * h / C_m)),
+          // written with expm1 so that it stays well defined for g_tot -> 0
+          const double x = g_tot * B_.step_ / P_->C_m_;
+          const double phi = x == 0.0 ? 1.0 : -numerics::expm1( -x ) / x;
+          S_.y_[ State_::V_M ] += ( I_0 - g_tot * S_.y_[ State_::V_M ] ) * B_.step_ / P_->C_m_ * phi;
+        }
+          break;
+      }
+    }
+
+    // drop the ports whose conductances have decayed
+    size_t n_active = 0;
+    for ( size_t k = 0; k < S_.active_receptors_.size(); ++k )
     {
-      const int status = gsl_odeiv_evolve_apply( B_.e_,
-        B_.c_,
-        B_.s_,
-        &B_.sys_,             // system of ODE
-        &t,                   // from t
-        B_.step_,             // to t <= step
-        &B_.IntegrationStep_, // integration step size
-        &S_.y_[0] );               // neuronal state
-      if ( status != GSL_SUCCESS )
+      if ( receptor_active_( S_.active_receptors_[ k ] ) )
       {
-        throw GSLSolverFailure( get_name(), status );
+        S_.active_receptors_[ n_active++ ] = S_.active_receptors_[ k ];
       }
     }
+    S_.active_receptors_.truncate( n_active );
 
-    if( V_.t_ref_remaining_ > 0.0)
+    if( S_.t_ref_remaining_ > 0.0)
     {
       // While neuron is in refractory period count-down in time steps (since dt
       // may change while in refractory) while holding the voltage at last peak.
-      V_.t_ref_remaining_ -= dt;
-      if( V_.t_ref_remaining_ <=0.0)
+      S_.t_ref_remaining_ -= dt;
+      if( S_.t_ref_remaining_ <=0.0)
       {
-          S_.y_[ State_::V_M ] = P_.V_reset_;
+          S_.y_[ State_::V_M ] = P_->V_reset_;
       }
       else
       {
@@ -453,13 +789,13 @@ nest::glif_lif_cond::update( Time const& origin, const long from, const long to
     else
     {
 
-      if( S_.y_[ State_::V_M ] >= P_.th_inf_ )
+      if( S_.y_[ State_::V_M ] >= P_->th_inf_ )
       {
 
-        V_.t_ref_remaining_ = V_.t_ref_total_;
+        S_.t_ref_remaining_ = V_.t_ref_total_;
 
         // Determine spike offset and send spike event
-        double spike_offset = (1 - (P_.th_inf_ - v_old)/(S_.y_[ State_::V_M ] - v_old)) * Time::get_resolution().get_ms();
+        double spike_offset = (1 - (P_->th_inf_ - v_old)/(S_.y_[ State_::V_M ] - v_old)) * Time::get_resolution().get_ms();
         set_spiketime( Time::step( origin.get_steps() + lag + 1 ), spike_offset );
         SpikeEvent se;
         se.set_offset(spike_offset);
@@ -468,14 +804,17 @@ nest::glif_lif_cond::update( Time const& origin, const long from, const long to
     }
 
     // add incoming spike
-    for( size_t i = 0; i < P_.n_receptors_(); i++ )
+    for( size_t i = 0; i < V_.class_port_.size(); i++ )
     {
       // Apply spikes delivered in this step: The spikes arriving at T+1 have an
       // immediate effect on the state of the neuron
-      S_.y_[ State_::DG_SYN
-        + ( State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR * i ) ] +=
-        B_.spikes_[ i ].get_value( lag ) * V_.CondInitialValues_[i]; // add incoming spike
-
+      const double weight = B_.spikes_[ i ].get_value( lag );
+      if ( weight != 0.0 )
+      {
+        S_.y_[ State_::DG_SYN + ( State_::NUMBER_OF_STATES_ELEMENTS_PER_RECEPTOR * i ) ] +=
+          weight * V_.CondInitialValues_[i]; // add incoming spike
+        S_.active_receptors_.insert( i );
+      }
     }
 
     B_.I_stim_ = B_.currents_.get_value( lag );
@@ -492,12 +831,17 @@ nest::glif_lif_cond::handles_test_event( SpikeEvent&,
   rport receptor_type )
 {
   if ( receptor_type <= 0
-    || receptor_type > static_cast< port >( P_.n_receptors_() ) )
+    || receptor_type > static_cast< port >( P_->n_receptors_() ) )
   {
     throw IncompatibleReceptorType( receptor_type, get_name(), "SpikeEvent" );
   }
 
-  P_.has_connections_ = true;
+  if ( not P_->has_connections_ )
+  {
+    Parameters_ ptmp = *P_;
+    ptmp.has_connections_ = true;
+    P_ = ptmp;
+  }
   return receptor_type;
 }
 
@@ -507,7 +851,7 @@ nest::glif_lif_cond::handle( SpikeEvent& e )
 {
   assert( e.get_delay() > 0 );
 
-  B_.spikes_[e.get_rport() - 1].add_value(
+  B_.spikes_[ V_.receptor_class_[ e.get_rport() - 1 ] ].add_value(
     e.get_rel_delivery_steps( kernel().simulation_manager.get_slice_origin() ),
     e.get_weight() * e.get_multiplicity() );
 }
@@ -0,0 +1,709 @@
+#include "glif_lif_psc_population.h"
+
+// C++ includes:
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+// Includes from libnestutil:
+#include "numerics.h"
+
+// Includes from nestkernel:
+#include "exceptions.h"
+#include "kernel_manager.h"
+#include "universal_data_logger_impl.h"
+#include "name.h"
+
+// Includes from sli:
+#include "arraydatum.h"
+#include "dict.h"
+#include "dictutils.h"
+#include "doubledatum.h"
+#include "integerdatum.h"
+#include "lockptrdatum.h"
+
+#include "glif_kernel.h"
+
+using namespace nest;
+
+nest::RecordablesMap< nest::glif_lif_psc_population > nest::glif_lif_psc_population::recordablesMap_;
+
+namespace nest
+{
+// Override the create() method with one call to RecordablesMap::insert_()
+// for each quantity to be recorded.
+template <>
+void
+RecordablesMap< glif_lif_psc_population >::create()
+{
+  insert_( names::V_m, &glif_lif_psc_population::get_V_m_ );
+  insert_( names::I_syn, &glif_lif_psc_population::get_I_syn_ );
+}
+}
+
+/* ----------------------------------------------------------------
+ * Default constructors defining default parameters and state
+ * ---------------------------------------------------------------- */
+
+nest::glif_lif_psc_population::Parameters_::Parameters_()
+  : th_inf_( 26.5 )   // in mV
+  , G_( 4.6951 )      // in nS
+  , E_L_( -77.4 )     // in mV
+  , C_m_( 99.182 )    // in pF
+  , t_ref_( 0.5 )     // in ms
+  , V_reset_( -77.4 ) // in mV
+  , tau_syn_( 1, 2.0 ) // in ms
+  , V_dynamics_method_( "linear_forward_euler" )
+  , has_connections_( false )
+{
+}
+
+nest::glif_lif_psc_population::State_::State_()
+  : V_m_( -77.4 )           // in mV
+  , I_( 0.0 )               // in pA
+  , I_syn_( 0.0 )           // in pA
+  , t_ref_remaining_( 0.0 ) // in ms
+{
+}
+
+nest::glif_lif_psc_population::Population_::Population_()
+  : updated_( false )
+  , last_slice_( -1 )
+{
+}
+
+/* ----------------------------------------------------------------
+ * Parameter and state extractions and manipulation functions
+ * ---------------------------------------------------------------- */
+
+void
+nest::glif_lif_psc_population::Parameters_::get( DictionaryDatum& d ) const
+{
+  def< double >( d, names::V_th, th_inf_ );
+  def< double >( d, names::g, G_ );
+  def< double >( d, names::E_L, E_L_ );
+  def< double >( d, names::C_m, C_m_ );
+  def< double >( d, names::t_ref, t_ref_ );
+  def< double >( d, names::V_reset, V_reset_ );
+
+  ArrayDatum tau_syn_ad( tau_syn_ );
+  def< ArrayDatum >( d, names::tau_syn, tau_syn_ad );
+
+  def< std::string >( d, "V_dynamics_method", V_dynamics_method_ );
+  def< bool >( d, names::has_connections, has_connections_ );
+}
+
+void
+nest::glif_lif_psc_population::Parameters_::set( const DictionaryDatum& d )
+{
+  updateValue< double >( d, names::V_th, th_inf_ );
+  updateValue< double >( d, names::g, G_ );
+  updateValue< double >( d, names::E_L, E_L_ );
+  updateValue< double >( d, names::C_m, C_m_ );
+  updateValue< double >( d, names::t_ref, t_ref_ );
+  updateValue< double >( d, names::V_reset, V_reset_ );
+  updateValue< std::string >( d, "V_dynamics_method", V_dynamics_method_ );
+
+  if ( V_reset_ >= th_inf_ )
+  {
+    throw BadProperty( "Reset potential must be smaller than threshold." );
+  }
+
+  // the population only takes the propagators of V_m from the method
+  const glif_v_dynamics_method* method = glif_find_v_dynamics_method( V_dynamics_method_ );
+  if ( method == 0 or method->full_state )
+  {
+    throw BadProperty(
+      "V_dynamics_method must be one of 'linear_forward_euler', 'linear_rk2', 'linear_exact' or "
+      "'linear_exact_event_driven'." );
+  }
+
+  if ( C_m_ <= 0.0 )
+  {
+    throw BadProperty( "Capacitance must be strictly positive." );
+  }
+
+  if ( G_ <= 0.0 )
+  {
+    throw BadProperty( "Membrane conductance must be strictly positive." );
+  }
+
+  if ( t_ref_ <= 0.0 )
+  {
+    throw BadProperty( "Refractory time constant must be strictly positive." );
+  }
+
+  const size_t old_n_receptors = this->n_receptors_();
+  if ( updateValue< std::vector< double > >( d, "tau_syn", tau_syn_ ) )
+  {
+    if ( this->n_receptors_() != old_n_receptors && has_connections_ == true )
+    {
+      throw BadProperty(
+        "The neuron has connections, therefore the number of ports cannot be "
+        "reduced." );
+    }
+    for ( size_t i = 0; i < tau_syn_.size(); ++i )
+    {
+      if ( tau_syn_[ i ] <= 0 )
+      {
+        throw BadProperty( "All synaptic time constants must be strictly positive." );
+      }
+    }
+  }
+}
+
+bool
+nest::glif_lif_psc_population::Parameters_::operator<( const Parameters_& p ) const
+{
+  return glif_flyweight_less(
+    std::tie( th_inf_, G_, E_L_, C_m_, t_ref_, V_reset_, tau_syn_, V_dynamics_method_, has_connections_ ),
+    std::tie( p.th_inf_, p.G_, p.E_L_, p.C_m_, p.t_ref_, p.V_reset_, p.tau_syn_, p.V_dynamics_method_,
+      p.has_connections_ ) );
+}
+
+void
+nest::glif_lif_psc_population::State_::get( DictionaryDatum& d ) const
+{
+  def< double >( d, names::V_m, V_m_ );
+}
+
+void
+nest::glif_lif_psc_population::State_::set( const DictionaryDatum& d, const Parameters_& p )
+{
+  updateValue< double >( d, names::V_m, V_m_ );
+  V_m_ = p.E_L_;
+}
+
+nest::glif_lif_psc_population::Buffers_::Buffers_( glif_lif_psc_population& n )
+  : logger_( n )
+  , logging_( false )
+{
+}
+
+nest::glif_lif_psc_population::Buffers_::Buffers_( const Buffers_&, glif_lif_psc_population& n )
+  : logger_( n )
+  , logging_( false )
+{
+}
+
+/* ----------------------------------------------------------------
+ * Population of a thread
+ * ---------------------------------------------------------------- */
+
+size_t
+nest::glif_lif_psc_population::Population_::add( glif_lif_psc_population& n,
+  const State_& s,
+  const Parameters_& p,
+  const double h )
+{
+  const size_t i = size();
+  members_.push_back( &n );
+
+  V_m_.push_back( 0.0 );
+  I_.push_back( 0.0 );
+  I_syn_.push_back( 0.0 );
+  t_ref_remaining_.push_back( 0.0 );
+  P_V_.push_back( 0.0 );
+  P30_.push_back( 0.0 );
+  I_leak_.push_back( 0.0 );
+  th_inf_.push_back( 0.0 );
+  V_reset_.push_back( 0.0 );
+  t_ref_total_.push_back( 0.0 );
+  for ( size_t r = 0; r < y1_.size(); ++r )
+  {
+    y1_[ r ].push_back( 0.0 );
+    y2_[ r ].push_back( 0.0 );
+    P11_[ r ].push_back( 0.0 );
+    P21_[ r ].push_back( 0.0 );
+    P31_[ r ].push_back( 0.0 );
+    P32_[ r ].push_back( 0.0 );
+    PSCInitialValues_[ r ].push_back( 0.0 );
+  }
+
+  V_new_.resize( size() );
+  I_syn_new_.resize( size() );
+  spike_offset_.resize( size() );
+  spiked_.resize( size() );
+  spikes_.resize( size() );
+
+  set_member( i, s, p, h );
+  return i;
+}
+
+void
+nest::glif_lif_psc_population::Population_::set_member( const size_t i,
+  const State_& s,
+  const Parameters_& p,
+  const double h )
+{
+  V_m_[ i ] = s.V_m_;
+  I_[ i ] = s.I_;
+  I_syn_[ i ] = s.I_syn_;
+  t_ref_remaining_[ i ] = s.t_ref_remaining_;
+
+  glif_find_v_dynamics_method( p.V_dynamics_method_ )->propagators( h, p.G_, p.C_m_, P_V_[ i ], P30_[ i ] );
+  I_leak_[ i ] = p.G_ * p.E_L_;
+  th_inf_[ i ] = p.th_inf_;
+  V_reset_[ i ] = p.V_reset_;
+  t_ref_total_[ i ] = p.t_ref_;
+
+  // ports the other members do not have are added with zero propagators
+  while ( y1_.size() < p.n_receptors_() )
+  {
+    y1_.push_back( std::vector< double >( size(), 0.0 ) );
+    y2_.push_back( std::vector< double >( size(), 0.0 ) );
+    P11_.push_back( std::vector< double >( size(), 0.0 ) );
+    P21_.push_back( std::vector< double >( size(), 0.0 ) );
+    P31_.push_back( std::vector< double >( size(), 0.0 ) );
+    P32_.push_back( std::vector< double >( size(), 0.0 ) );
+    PSCInitialValues_.push_back( std::vector< double >( size(), 0.0 ) );
+  }
+
+  const double Tau = p.C_m_ / p.G_; // in ms
+  for ( size_t r = 0; r < y1_.size(); ++r )
+  {
+    if ( r < p.n_receptors_() )
+    {
+      const double P11 = std::exp( -h / p.tau_syn_[ r ] );
+      y1_[ r ][ i ] = s.y1_[ r ];
+      y2_[ r ][ i ] = s.y2_[ r ];
+      P11_[ r ][ i ] = P11;
+      P21_[ r ][ i ] = h * P11;
+      P31_[ r ][ i ] = glif_propagator_31( p.tau_syn_[ r ], Tau, p.C_m_, h );
+      P32_[ r ][ i ] = glif_propagator_32( p.tau_syn_[ r ], Tau, p.C_m_, h );
+      PSCInitialValues_[ r ][ i ] = 1.0 * numerics::e / p.tau_syn_[ r ];
+    }
+    else
+    {
+      y1_[ r ][ i ] = 0.0;
+      y2_[ r ][ i ] = 0.0;
+      P11_[ r ][ i ] = 0.0;
+      P21_[ r ][ i ] = 0.0;
+      P31_[ r ][ i ] = 0.0;
+      P32_[ r ][ i ] = 0.0;
+      PSCInitialValues_[ r ][ i ] = 0.0;
+    }
+  }
+}
+
+void
+nest::glif_lif_psc_population::Population_::clear()
+{
+  for ( size_t i = 0; i < size(); ++i )
+  {
+    if ( members_[ i ] )
+    {
+      get_state( i, members_[ i ]->S_ );
+      members_[ i ]->population_ = 0;
+    }
+  }
+
+  members_.clear();
+  updated_ = false;
+  last_slice_ = -1;
+
+  V_m_.clear();
+  I_.clear();
+  I_syn_.clear();
+  t_ref_remaining_.clear();
+  y1_.clear();
+  y2_.clear();
+  P_V_.clear();
+  P30_.clear();
+  I_leak_.clear();
+  th_inf_.clear();
+  V_reset_.clear();
+  t_ref_total_.clear();
+  P11_.clear();
+  P21_.clear();
+  P31_.clear();
+  P32_.clear();
+  PSCInitialValues_.clear();
+  V_new_.clear();
+  I_syn_new_.clear();
+  spike_offset_.clear();
+  spiked_.clear();
+  spikes_.clear();
+}
+
+void
+nest::glif_lif_psc_population::Population_::get_state( const size_t i, State_& s ) const
+{
+  s.V_m_ = V_m_[ i ];
+  s.I_ = I_[ i ];
+  s.I_syn_ = I_syn_[ i ];
+  s.t_ref_remaining_ = t_ref_remaining_[ i ];
+  for ( size_t r = 0; r < s.y1_.size() && r < y1_.size(); ++r )
+  {
+    s.y1_[ r ] = y1_[ r ][ i ];
+    s.y2_[ r ] = y2_[ r ][ i ];
+  }
+}
+
+void
+nest::glif_lif_psc_population::Population_::set_state( const size_t i, const State_& s )
+{
+  V_m_[ i ] = s.V_m_;
+  I_[ i ] = s.I_;
+  I_syn_[ i ] = s.I_syn_;
+  t_ref_remaining_[ i ] = s.t_ref_remaining_;
+  for ( size_t r = 0; r < s.y1_.size() && r < y1_.size(); ++r )
+  {
+    y1_[ r ][ i ] = s.y1_[ r ];
+    y2_[ r ][ i ] = s.y2_[ r ];
+  }
+}
+
+nest::glif_lif_psc_population::Population_&
+nest::glif_lif_psc_population::thread_population_( const thread t )
+{
+  // never freed, members may still refer to it while static objects are
+  // destroyed
+  static std::map< thread, Population_* >* populations = new std::map< thread, Population_* >();
+
+  Population_* p = 0;
+#pragma omp critical( glif_lif_psc_population )
+  {
+    Population_*& entry = ( *populations )[ t ];
+    if ( entry == 0 )
+    {
+      entry = new Population_();
+    }
+    p = entry;
+  }
+  return *p;
+}
+
+/* ----------------------------------------------------------------
+ * Default and copy constructor for node
+ * ---------------------------------------------------------------- */
+
+nest::glif_lif_psc_population::glif_lif_psc_population()
+  : Archiving_Node()
+  , P_()
+  , S_()
+  , B_( *this )
+  , population_( 0 )
+  , index_( 0 )
+{
+  recordablesMap_.create();
+}
+
+nest::glif_lif_psc_population::glif_lif_psc_population( const glif_lif_psc_population& n )
+  : Archiving_Node( n )
+  , P_( n.P_ )
+  , S_( n.S_ )
+  , B_( n.B_, *this )
+  , population_( 0 )
+  , index_( 0 )
+{
+}
+
+nest::glif_lif_psc_population::~glif_lif_psc_population()
+{
+  if ( population_ )
+  {
+    population_->members_[ index_ ] = 0;
+  }
+}
+
+/* ----------------------------------------------------------------
+ * Node initialization functions
+ * ---------------------------------------------------------------- */
+
+void
+nest::glif_lif_psc_population::init_state_( const Node& proto )
+{
+  const glif_lif_psc_population& pr = downcast< glif_lif_psc_population >( proto );
+  S_ = pr.S_;
+  if ( population_ )
+  {
+    population_->set_state( index_, S_ );
+  }
+}
+
+void
+nest::glif_lif_psc_population::init_buffers_()
+{
+  B_.spikes_.clear();   // includes resize
+  B_.currents_.clear(); // include resize
+  B_.logger_.reset();   // includes resize
+}
+
+void
+nest::glif_lif_psc_population::calibrate()
+{
+  B_.logger_.init();
+
+  // calibrate() of the first neuron of a new simulation dissolves the
+  // population of the last one, which copies the state back to the members
+  Population_& population = thread_population_( get_thread() );
+  if ( population.updated_ )
+  {
+    population.clear();
+  }
+  if ( population_ )
+  {
+    population_->get_state( index_, S_ );
+  }
+
+  S_.t_ref_remaining_ = 0.0;
+  S_.y1_.resize( P_->n_receptors_() );
+  S_.y2_.resize( P_->n_receptors_() );
+
+  B_.spikes_.resize( P_->n_receptors_() );
+  for ( size_t i = 0; i < P_->n_receptors_(); i++ )
+  {
+    B_.spikes_[ i ].resize();
+  }
+
+  // frozen neurons are not updated by NEST, so they stay out of the
+  // population that the other neurons update
+  if ( is_frozen() )
+  {
+    if ( population_ )
+    {
+      population_->members_[ index_ ] = 0;
+      population_ = 0;
+    }
+    return;
+  }
+
+  // a member calibrated again before the population was updated, e.g. by
+  // Simulate(0), keeps its index, so that repeated calibrations do not leave
+  // unused members that are still propagated
+  const double h = Time::get_resolution().get_ms(); // in ms
+  if ( population_ == &population )
+  {
+    population.set_member( index_, S_, *P_, h );
+  }
+  else
+  {
+    index_ = population.add( *this, S_, *P_, h );
+    population_ = &population;
+  }
+}
+
+/* ----------------------------------------------------------------
+ * Update and spike handling functions
+ * ---------------------------------------------------------------- */
+
+void
+nest::glif_lif_psc_population::update( Time const& origin, const long from, const long to )
+{
+  // the first member updated in this slice updates all of them
+  Population_& population = *population_;
+  const long slice = origin.get_steps() + from;
+  if ( population.updated_ and population.last_slice_ == slice )
+  {
+    return;
+  }
+  population.updated_ = true;
+  population.last_slice_ = slice;
+
+  update_population_( origin, from, to );
+}
+
+void
+nest::glif_lif_psc_population::update_population_( Time const& origin, const long from, const long to )
+{
+  Population_& p = *population_;
+  const size_t n = p.size();
+  const size_t n_ports = p.y1_.size();
+  const double dt = Time::get_resolution().get_ms();
+
+  double* const V_m = p.V_m_.data();
+  double* const I = p.I_.data();
+  double* const I_syn = p.I_syn_.data();
+  double* const t_ref_remaining = p.t_ref_remaining_.data();
+  const double* const P_V = p.P_V_.data();
+  const double* const P30 = p.P30_.data();
+  const double* const I_leak = p.I_leak_.data();
+  const double* const th_inf = p.th_inf_.data();
+  const double* const V_reset = p.V_reset_.data();
+  const double* const t_ref_total = p.t_ref_total_.data();
+  double* const V_new = p.V_new_.data();
+  double* const I_syn_new = p.I_syn_new_.data();
+  double* const spike_offset = p.spike_offset_.data();
+  double* const spiked = p.spiked_.data();
+  size_t* const spikes = p.spikes_.data();
+
+  for ( long lag = from; lag < to; ++lag )
+  {
+    // voltage dynamics of membranes, the same for all methods
+#pragma omp simd
+    for ( size_t i = 0; i < n; ++i )
+    {
+      V_new[ i ] = V_m[ i ] * P_V[ i ] + ( I[ i ] + I_leak[ i ] ) * P30[ i ];
+      I_syn_new[ i ] = 0.0;
+    }
+
+    // add synapse component for voltage dynamics
+    for ( size_t r = 0; r < n_ports; ++r )
+    {
+      const double* const y1 = p.y1_[ r ].data();
+      const double* const y2 = p.y2_[ r ].data();
+      const double* const P31 = p.P31_[ r ].data();
+      const double* const P32 = p.P32_[ r ].data();
+#pragma omp simd
+      for ( size_t i = 0; i < n; ++i )
+      {
+        V_new[ i ] += P31[ i ] * y1[ i ] + P32[ i ] * y2[ i ];
+        I_syn_new[ i ] += y2[ i ];
+      }
+    }
+
+    // The refractory, reset and spike conditions are evaluated as masks that
+    // select between values computed for all members. The loops are split
+    // and every operand is loaded before the selection, so that no
+    // floating point operation is conditional and the loops vectorize
+    // without fast-math.
+
+    // I_syn is held while refractory
+#pragma omp simd
+    for ( size_t i = 0; i < n; ++i )
+    {
+      const double I_syn_held = I_syn[ i ];
+      const double I_syn_free = I_syn_new[ i ];
+      I_syn[ i ] = t_ref_remaining[ i ] > 0.0 ? I_syn_held : I_syn_free;
+    }
+
+    // V_m is held while refractory and reset in the last refractory step
+#pragma omp simd
+    for ( size_t i = 0; i < n; ++i )
+    {
+      const double v_old = V_m[ i ];
+      const double t_ref = t_ref_remaining[ i ];
+      const double V_reset_i = V_reset[ i ];
+      const double V_free = V_new[ i ];
+      const double th = th_inf[ i ];
+
+      const double V_held = t_ref <= dt ? V_reset_i : v_old;
+      const double V = t_ref > 0.0 ? V_held : V_free;
+
+      // the exact time during this step that the neuron crossed the threshold,
+      // only used if it spiked
+      spike_offset[ i ] = ( 1 - ( v_old - th ) / ( v_old - V ) ) * dt;
+      V_m[ i ] = V;
+    }
+
+    // members that were not refractory spike if V_m exceeds the threshold and
+    // become refractory, the others count down
+#pragma omp simd
+    for ( size_t i = 0; i < n; ++i )
+    {
+      const double t_ref = t_ref_remaining[ i ];
+      const double t_ref_total_i = t_ref_total[ i ];
+      const double above = V_m[ i ] > th_inf[ i ] ? 1.0 : 0.0;
+      const double spike = t_ref > 0.0 ? 0.0 : above;
+      const double t_ref_counted = std::max( t_ref - dt, 0.0 );
+
+      spiked[ i ] = spike;
+      t_ref_remaining[ i ] = spike != 0.0 ? t_ref_total_i : t_ref_counted;
+    }
+
+    // compress the indices of the members that spiked
+    size_t n_spikes = 0;
+    for ( size_t i = 0; i < n; ++i )
+    {
+      spikes[ n_spikes ] = i;
+      n_spikes += spiked[ i ] != 0.0;
+    }
+
+    for ( size_t k = 0; k < n_spikes; ++k )
+    {
+      glif_lif_psc_population* const member = p.members_[ spikes[ k ] ];
+      if ( member )
+      {
+        const double offset = spike_offset[ spikes[ k ] ];
+        member->set_spiketime( Time::step( origin.get_steps() + lag + 1 ), offset );
+        SpikeEvent se;
+        se.set_offset( offset );
+        kernel().event_delivery_manager.send( *member, se, lag );
+      }
+    }
+
+    // alpha shape PSCs
+    for ( size_t r = 0; r < n_ports; ++r )
+    {
+      double* const y1 = p.y1_[ r ].data();
+      double* const y2 = p.y2_[ r ].data();
+      const double* const P11 = p.P11_[ r ].data();
+      const double* const P21 = p.P21_[ r ].data();
+#pragma omp simd
+      for ( size_t i = 0; i < n; ++i )
+      {
+        y2[ i ] = P21[ i ] * y1[ i ] + P11[ i ] * y2[ i ];
+        y1[ i ] *= P11[ i ];
+      }
+    }
+
+    // Apply spikes delivered in this step and update any external currents,
+    // read from the buffers of the members
+    for ( size_t i = 0; i < n; ++i )
+    {
+      glif_lif_psc_population* const member = p.members_[ i ];
+      if ( member == 0 )
+      {
+        continue;
+      }
+      for ( size_t r = 0; r < member->B_.spikes_.size(); ++r )
+      {
+        p.y1_[ r ][ i ] += p.PSCInitialValues_[ r ][ i ] * member->B_.spikes_[ r ].get_value( lag );
+      }
+      I[ i ] = member->B_.currents_.get_value( lag );
+
+      // Save voltage
+      if ( member->B_.logging_ )
+      {
+        member->B_.logger_.record_data( origin.get_steps() + lag );
+      }
+    }
+  }
+}
+
+port
+nest::glif_lif_psc_population::handles_test_event( SpikeEvent&, rport receptor_type )
+{
+  if ( receptor_type <= 0 || receptor_type > static_cast< port >( P_->n_receptors_() ) )
+  {
+    throw IncompatibleReceptorType( receptor_type, get_name(), "SpikeEvent" );
+  }
+
+  if ( not P_->has_connections_ )
+  {
+    Parameters_ ptmp = *P_;
+    ptmp.has_connections_ = true;
+    P_ = ptmp;
+  }
+  return receptor_type;
+}
+
+void
+nest::glif_lif_psc_population::handle( SpikeEvent& e )
+{
+  assert( e.get_delay() > 0 );
+
+  B_.spikes_[ e.get_rport() - 1 ].add_value(
+    e.get_rel_delivery_steps( kernel().simulation_manager.get_slice_origin() ),
+    e.get_weight() * e.get_multiplicity() );
+}
+
+void
+nest::glif_lif_psc_population::handle( CurrentEvent& e )
+{
+  assert( e.get_delay() > 0 );
+
+  B_.currents_.add_value(
+    e.get_rel_delivery_steps( kernel().simulation_manager.get_slice_origin() ),
+    e.get_weight() * e.get_current() );
+}
+
+// Do not move this function as inline to h-file. It depends on
+// universal_data_logger_impl.h being included here.
+void
+nest::glif_lif_psc_population::handle( DataLoggingRequest& e )
+{
+  B_.logger_.handle( e ); // the logger does this for us
+}
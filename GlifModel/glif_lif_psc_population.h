@@ -0,0 +1,371 @@
+#ifndef GLIF_LIF_PSC_POPULATION_H
+#define GLIF_LIF_PSC_POPULATION_H
+
+// C++ includes:
+#include <string>
+#include <vector>
+
+// Includes from nestkernel:
+#include "archiving_node.h"
+#include "connection.h"
+#include "event.h"
+#include "nest_types.h"
+#include "ring_buffer.h"
+#include "universal_data_logger.h"
+
+// Includes from sli:
+#include "dictdatum.h"
+
+#include "glif_flyweight.h"
+
+/* BeginDocumentation
+Name: glif_lif_psc_population - glif_lif_psc neurons updated together in
+                                structure-of-arrays form.
+
+Description:
+
+  glif_lif_psc_population has the dynamics, parameters and receptor ports of
+  glif_lif_psc, the generalized leaky integrate and fire (GLIF) model 1 [1]
+  with alpha-function shaped synaptic currents. It differs in how the neurons
+  are updated: all glif_lif_psc_population neurons of a thread form one
+  population, whose state and per-step propagators are stored in structure-
+  of-arrays form, one contiguous array per quantity. The first neuron of the
+  population that is updated in a time slice updates all of them, one step at
+  a time, with loops over the neurons that the compiler vectorizes: V_m and
+  the synaptic currents are propagated with per-neuron propagators, the
+  refractory and threshold conditions are evaluated as masks, and the indices
+  of the neurons that spike are compressed into a list from which the spike
+  events are sent. The other neurons only return from their update.
+
+  Each neuron remains a node of its own, with its own GID, status dictionary,
+  receptor ports, input buffers and multimeter, and sends its spikes under its
+  own GID, so that it is connected and recorded like a glif_lif_psc neuron.
+  The population is formed again at the start of each simulation from the
+  neurons of the thread, whatever their parameters. Frozen neurons are left
+  out, so that they keep their state like other frozen nodes.
+
+  The model follows glif_lif_psc step by step, except that it has no
+  quiescence fast path, so that neurons at rest may differ in round-off.
+  'linear_exact_event_driven' is updated like 'linear_exact', and
+  'matrix_exponential' is not available.
+
+Parameters:
+
+  The following parameters can be set in the status dictionary.
+
+  V_m               double - Membrane potential in mV
+  V_th              double - Instantaneous threshold in mV.
+  g                 double - Membrane conductance in nS.
+  E_L               double - Resting membrane potential in mV.
+  C_m               double - Capacitance of the membrane in pF.
+  t_ref             double - Duration of refractory time in ms.
+  V_reset           double - Reset potential of the membrane in mV.
+  tau_syn           double vector - Rise time constants of the synaptic alpha function in ms.
+  V_dynamics_method string - Voltage dynamics (Equation (1) in [1]) solution methods:
+                             'linear_forward_euler' - Linear Euler forward (RK1) to find next V_m value, or
+                             'linear_rk2' - Linear second-order Runge-Kutta (Heun) to find next V_m value, or
+                             'linear_exact' - Linear exact to find next V_m value.
+
+References:
+  [1] Teeter C, Iyer R, Menon V, Gouwens N, Feng D, Berg J, Szafer A,
+      Cain N, Zeng H, Hawrylycz M, Koch C, & Mihalas S (2018)
+      Generalized leaky integrate-and-fire models classify multiple neuron types.
+      Nature Communications 9:709.
+
+SeeAlso: glif_lif_psc
+*/
+
+namespace nest
+{
+
+class glif_lif_psc_population : public Archiving_Node
+{
+public:
+  glif_lif_psc_population();
+
+  glif_lif_psc_population( const glif_lif_psc_population& );
+
+  ~glif_lif_psc_population();
+
+  using Node::handle;
+  using Node::handles_test_event;
+
+  port send_test_event( Node&, port, synindex, bool );
+
+  void handle( SpikeEvent& );
+  void handle( CurrentEvent& );
+  void handle( DataLoggingRequest& );
+
+  port handles_test_event( SpikeEvent&, port );
+  port handles_test_event( CurrentEvent&, port );
+  port handles_test_event( DataLoggingRequest&, port );
+
+  bool is_off_grid() const // uses off_grid events
+  {
+    return true;
+  }
+
+  void get_status( DictionaryDatum& ) const;
+  void set_status( const DictionaryDatum& );
+
+private:
+  struct Population_;
+
+  //! Reset state of neuron.
+  void init_state_( const Node& proto );
+
+  //! Reset internal buffers of neuron.
+  void init_buffers_();
+
+  //! Initialize auxiliary quantities and join the population of the thread
+  void calibrate();
+
+  //! Take the population through given time interval, if no other neuron did
+  void update( Time const&, const long, const long );
+
+  //! Population of the given thread
+  static Population_& thread_population_( const thread );
+
+  // The next two classes need to be friends to access the State_ class/member
+  friend class RecordablesMap< glif_lif_psc_population >;
+  friend class UniversalDataLogger< glif_lif_psc_population >;
+
+  struct Parameters_
+  {
+    double th_inf_;  // infinity threshold in mV
+    double G_;       // membrane conductance in nS
+    double E_L_;     // resting potential in mV
+    double C_m_;     // capacitance in pF
+    double t_ref_;   // refractory time in ms
+    double V_reset_; // reset potential in mV
+
+    std::vector< double > tau_syn_; // synaptic port time constants in ms
+
+    std::string V_dynamics_method_; // voltage dynamic methods
+
+    // boolean flag which indicates whether the neuron has connections
+    bool has_connections_;
+
+    size_t n_receptors_() const; //!< Returns the size of tau_syn_
+
+    Parameters_();
+
+    void get( DictionaryDatum& ) const;
+    void set( const DictionaryDatum& );
+
+    //! Order of all members, used to share equal parameter sets
+    bool operator<( const Parameters_& ) const;
+  };
+
+  //! State of the neuron while it is not part of a population
+  struct State_
+  {
+    double V_m_;             // membrane potential in mV
+    double I_;               // external current in pA
+    double I_syn_;           // post synaptic current in pA
+    double t_ref_remaining_; // counter during refractory period, in ms
+
+    std::vector< double > y1_; // synapse current evolution state 1 in pA
+    std::vector< double > y2_; // synapse current evolution state 2 in pA
+
+    State_();
+
+    void get( DictionaryDatum& ) const;
+    void set( const DictionaryDatum&, const Parameters_& );
+  };
+
+  struct Buffers_
+  {
+    Buffers_( glif_lif_psc_population& );
+    Buffers_( const Buffers_&, glif_lif_psc_population& );
+
+    //! Buffer incoming spikes through delay, as sum, one per receptor port
+    std::vector< RingBuffer > spikes_;
+    RingBuffer currents_; //!< Buffer incoming currents through delay,
+
+    //! Logger for all analog data
+    UniversalDataLogger< glif_lif_psc_population > logger_;
+
+    bool logging_; //!< true if a multimeter is connected
+  };
+
+  /**
+   * The glif_lif_psc_population neurons of one thread. While a neuron is a
+   * member, its state lives here at its index instead of in its State_.
+   * Receptor quantities are stored per receptor port over all members; the
+   * ports a member does not have hold zero propagators.
+   */
+  struct Population_
+  {
+    std::vector< glif_lif_psc_population* > members_; // 0 for destroyed members
+    bool updated_;    // updated since the members joined
+    long last_slice_; // origin + from of the last updated slice, in steps
+
+    // state
+    std::vector< double > V_m_;             // membrane potential in mV
+    std::vector< double > I_;               // external current in pA
+    std::vector< double > I_syn_;           // post synaptic current in pA
+    std::vector< double > t_ref_remaining_; // counter during refractory period, in ms
+    std::vector< std::vector< double > > y1_; // synapse current evolution state 1 in pA, per port
+    std::vector< std::vector< double > > y2_; // synapse current evolution state 2 in pA, per port
+
+    // per-step propagators, see glif_neuron
+    std::vector< double > P_V_;          // decay of V_m towards its equilibrium
+    std::vector< double > P30_;          // membrane current/voltage evolution parameter
+    std::vector< double > I_leak_;       // leak current at rest G E_L in pA
+    std::vector< double > th_inf_;       // threshold in mV
+    std::vector< double > V_reset_;      // reset potential in mV
+    std::vector< double > t_ref_total_;  // total time of refractory period, in ms
+    std::vector< std::vector< double > > P11_; // synaptic current evolution parameter, P22 = P11
+    std::vector< std::vector< double > > P21_; // synaptic current evolution parameter
+    std::vector< std::vector< double > > P31_; // synaptic/membrane current evolution parameter
+    std::vector< std::vector< double > > P32_; // synaptic/membrane current evolution parameter
+    std::vector< std::vector< double > > PSCInitialValues_; // amplitude of the synaptic current
+
+    // per-step scratch
+    std::vector< double > V_new_;        // V_m of the members that are not refractory, in mV
+    std::vector< double > I_syn_new_;    // I_syn of the members that are not refractory, in pA
+    std::vector< double > spike_offset_; // spike offset in ms
+    std::vector< double > spiked_;       // 1 for the members that spiked, 0 otherwise
+    std::vector< size_t > spikes_;       // indices of the members that spiked
+
+    Population_();
+
+    size_t size() const;
+
+    //! Adds the neuron with the given state and propagators, returns its index
+    size_t add( glif_lif_psc_population&, const State_&, const Parameters_&, const double );
+
+    //! Sets the state and propagators of the given member
+    void set_member( const size_t, const State_&, const Parameters_&, const double );
+
+    //! Copies the state back to the members and removes them
+    void clear();
+
+    //! Copies the state of the given member to s
+    void get_state( const size_t, State_& s ) const;
+
+    //! Sets the state of the given member to s
+    void set_state( const size_t, const State_& s );
+  };
+
+  //! Update of all members of the population
+  void update_population_( Time const&, const long, const long );
+
+  double
+  get_V_m_() const
+  {
+    return population_ ? population_->V_m_[ index_ ] : S_.V_m_;
+  }
+
+  double
+  get_I_syn_() const
+  {
+    return population_ ? population_->I_syn_[ index_ ] : S_.I_syn_;
+  }
+
+  glif_flyweight< Parameters_ > P_; //!< Free parameters, shared by equal sets.
+  State_ S_;                        //!< Dynamic state outside of a population.
+  Buffers_ B_;                      //!< Buffers.
+
+  Population_* population_; //!< population the neuron is a member of, or 0
+  size_t index_;            //!< index of the neuron in the population
+
+  //! Mapping of recordables names to access functions
+  static RecordablesMap< glif_lif_psc_population > recordablesMap_;
+};
+
+inline size_t
+glif_lif_psc_population::Parameters_::n_receptors_() const
+{
+  return tau_syn_.size();
+}
+
+inline size_t
+glif_lif_psc_population::Population_::size() const
+{
+  return members_.size();
+}
+
+inline port
+glif_lif_psc_population::send_test_event( Node& target, port receptor_type, synindex, bool )
+{
+  SpikeEvent e;
+  e.set_sender( *this );
+  return target.handles_test_event( e, receptor_type );
+}
+
+inline port
+glif_lif_psc_population::handles_test_event( CurrentEvent&, port receptor_type )
+{
+  if ( receptor_type != 0 )
+  {
+    throw UnknownReceptorType( receptor_type, get_name() );
+  }
+  return 0;
+}
+
+inline port
+glif_lif_psc_population::handles_test_event( DataLoggingRequest& dlr, port receptor_type )
+{
+  if ( receptor_type != 0 )
+  {
+    throw UnknownReceptorType( receptor_type, get_name() );
+  }
+
+  B_.logging_ = true;
+  return B_.logger_.connect_logging_device( dlr, recordablesMap_ );
+}
+
+inline void
+glif_lif_psc_population::get_status( DictionaryDatum& d ) const
+{
+  // get our own parameter and state data
+  P_->get( d );
+  if ( population_ )
+  {
+    State_ s = S_;
+    population_->get_state( index_, s );
+    s.get( d );
+  }
+  else
+  {
+    S_.get( d );
+  }
+
+  // get information managed by parent class
+  Archiving_Node::get_status( d );
+
+  ( *d )[ names::recordables ] = recordablesMap_.get_list();
+}
+
+inline void
+glif_lif_psc_population::set_status( const DictionaryDatum& d )
+{
+  Parameters_ ptmp = *P_; // temporary copy in case of errors
+  ptmp.set( d );          // throws if BadProperty
+  State_ stmp = S_;       // temporary copy in case of errors
+  if ( population_ )
+  {
+    population_->get_state( index_, stmp );
+  }
+  stmp.set( d, ptmp ); // throws if BadProperty
+
+  // We now know that (ptmp, stmp) are consistent. We do not
+  // write them back to (P_, S_) before we are also sure that
+  // the properties to be set in the parent class are internally
+  // consistent.
+  Archiving_Node::set_status( d );
+
+  // if we get here, temporaries contain consistent set of properties
+  P_ = ptmp;
+  S_ = stmp;
+  if ( population_ )
+  {
+    population_->set_state( index_, S_ );
+  }
+}
+
+} // namespace nest
+
+#endif
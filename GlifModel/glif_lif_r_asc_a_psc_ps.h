@@ -0,0 +1,82 @@
+#ifndef GLIF_LIF_R_ASC_A_PSC_PS_H
+#define GLIF_LIF_R_ASC_A_PSC_PS_H
+
+#include "glif_neuron_ps.h"
+
+/* BeginDocumentation
+Name: glif_lif_r_asc_a_psc_ps - Generalized leaky integrate and fire (GLIF) model 5 -
+                                Leaky integrate and fire with biologically defined
+                                reset rules, after-spike currents and a voltage
+                                dependent threshold model,
+                                with precise spike timing.
+
+Description:
+
+  glif_lif_r_asc_a_psc_ps is an implementation of a generalized leaky integrate and fire (GLIF) model 5
+  (i.e., leaky integrate and fire with biologically defined reset rules, after-spike currents
+  and a voltage dependent threshold model) [1] with alpha-function shaped
+  synaptic currents. Incoming spike events induce a post-synaptic change of current modeled
+  by an alpha function. The alpha function is normalized such that an event of weight 1.0
+  results in a peak current of 1 pA at t = tau_syn. On the postsynapic side, there can be
+  arbitrarily many synaptic time constants. This can be reached by specifying separate receptor ports,
+  each for a different time constant. The port number has to match the respective
+  "receptor_type" in the connectors.
+
+  glif_lif_r_asc_a_psc_ps is glif_lif_r_asc_a_psc with precise spike timing: incoming
+  spikes take effect at their offsets within the time step, the neuron is integrated
+  exactly from spike to spike, and threshold crossings are located by root finding on the
+  exact solution, so that its spike times and resets do not depend on the resolution. The
+  membrane potential is always integrated with the linear exact method; currents take
+  effect at the step boundaries.
+
+Parameters:
+
+  The following parameters can be set in the status dictionary.
+
+  V_m               double - Membrane potential in mV
+  V_th              double - Instantaneous threshold in mV.
+  g                 double - Membrane conductance in nS.
+  E_L               double - Resting membrane potential in mV.
+  C_m               double - Capacitance of the membrane in pF.
+  t_ref             double - Duration of refractory time in ms.
+  a_spike           double - Threshold addition following spike in mV.
+  b_spike           double - Spike-induced threshold time constant in 1/ms.
+  a_reset           double - Voltage fraction coefficient following spike.
+  b_reset           double - Voltage addition following spike in mV.
+  asc_init          double vector - Initial values of after-spike currents in pA.
+  k                 double vector - After-spike current time constants in 1/ms (kj in Equation (3) in [1]).
+  asc_amps          double vector - After-spike current amplitudes in pA (deltaIj in Equation (7) in [1]).
+  r                 double vector - Current fraction following spike coefficients (fj in Equation (7) in [1]).
+  a_voltage         double - Adaptation index of threshold - A 'leak-conductance' for the voltage-dependent
+                             component of the threshold in 1/ms (av in Equation (4) in [1]).
+  b_voltage         double - Voltage-induced threshold time constant - Inverse of which is the time constant
+                             of the voltage-dependent component of the threshold in 1/ms (bv in Equation (4) in [1]).
+  tau_syn           double vector - Rise time constants of the synaptic alpha function in ms.
+                             Ports with equal tau_syn share one synaptic current, which receives the
+                             spikes of all of them.
+  receptor_tol      double - Synaptic current in pA within which a receptor port is inactive. Ports are
+                             only propagated while active, from a spike arriving at them until their
+                             current has decayed to within the tolerance and is set to zero. The
+                             default, the smallest normal double, drops ports before their decay
+                             reaches subnormal values, which are slow to compute.
+
+References:
+  [1] Teeter C, Iyer R, Menon V, Gouwens N, Feng D, Berg J, Szafer A,
+      Cain N, Zeng H, Hawrylycz M, Koch C, & Mihalas S (2018)
+      Generalized leaky integrate-and-fire models classify multiple neuron types.
+      Nature Communications 9:709.
+
+SeeAlso: glif_lif_r_asc_a_psc
+*/
+
+namespace nest
+{
+
+typedef glif_neuron_ps< glif_reset_rules, glif_asc, glif_voltage_threshold, glif_alpha_psc > glif_lif_r_asc_a_psc_ps;
+
+template <>
+void RecordablesMap< glif_lif_r_asc_a_psc_ps >::create();
+
+} // namespace nest
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef GLIF_NEURON_H
+#define GLIF_NEURON_H
+
+// C++ includes:
+#include <string>
+#include <vector>
+
+// Includes from nestkernel:
+#include "archiving_node.h"
+#include "connection.h"
+#include "event.h"
+#include "nest_types.h"
+#include "ring_buffer.h"
+#include "universal_data_logger.h"
+
+// Includes from sli:
+#include "dictdatum.h"
+
+#include "glif_flyweight.h"
+#include "glif_kernel.h"
+
+namespace nest
+{
+
+/**
+ * Common implementation of the current based GLIF models [1], which differ
+ * in the mechanisms selected by the policies TReset, TASC, TThreshold and
+ * TSynapse. Each model is a typedef of an instantiation and is registered
+ * under its own name in glifmodule.cpp; its documentation lives in its own
+ * header.
+ *
+ * The dynamics, parameters, state and per-step propagators are those of
+ * glif_kernel, which builds without NEST; glif_neuron adds the dictionary
+ * access, the input buffers, the spike events, the recording and the fast
+ * paths for steps without change.
+ *
+ * References:
+ *   [1] Teeter C, Iyer R, Menon V, Gouwens N, Feng D, Berg J, Szafer A,
+ *       Cain N, Zeng H, Hawrylycz M, Koch C, & Mihalas S (2018)
+ *       Generalized leaky integrate-and-fire models classify multiple neuron
+ *       types. Nature Communications 9:709.
+ */
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+class glif_neuron : public Archiving_Node
+{
+public:
+  glif_neuron();
+
+  glif_neuron( const glif_neuron& );
+
+  using Node::handle;
+  using Node::handles_test_event;
+
+  port send_test_event( Node&, port, synindex, bool );
+
+  void handle( SpikeEvent& );
+  void handle( CurrentEvent& );
+  void handle( DataLoggingRequest& );
+
+  port handles_test_event( SpikeEvent&, port );
+  port handles_test_event( CurrentEvent&, port );
+  port handles_test_event( DataLoggingRequest&, port );
+
+  bool is_off_grid() const // uses off_grid events
+  {
+    return true;
+  }
+
+  void get_status( DictionaryDatum& ) const;
+  void set_status( const DictionaryDatum& );
+
+private:
+  typedef glif_kernel< TReset, TASC, TThreshold, TSynapse > Kernel_;
+
+  //! Reset state of neuron.
+  void init_state_( const Node& proto );
+
+  //! Reset internal buffers of neuron.
+  void init_buffers_();
+
+  //! Initialize auxiliary quantities, leave parameters and state untouched.
+  void calibrate();
+
+  //! Take neuron through given time interval
+  void update( Time const&, const long, const long );
+
+  //! Update loop with the after-spike currents and the voltage component of
+  //! the threshold only if enabled here, selected in calibrate() by the
+  //! components that are active. Without voltage component of the threshold
+  //! and synaptic currents, V_m and the threshold are propagated in closed
+  //! form over steps with constant input, see jump_slice_().
+  template < bool ASC, bool VoltageThreshold >
+  void update_steps_( Time const&, const long, const long );
+
+  //! Check whether the neuron rests at equilibrium without input, see quiescence_tol
+  bool is_quiescent_();
+
+  //! Cross the slice in closed form if the input is constant and no spike can
+  //! occur, returns false if the slice has to be updated step by step
+  bool jump_slice_( Time const&, const long, const long );
+
+  // The next two classes need to be friends to access the State_ class/member
+  friend class RecordablesMap< glif_neuron >;
+  friend class UniversalDataLogger< glif_neuron >;
+
+  struct Parameters_ : public Kernel_::Parameters
+  {
+    double quiescence_tol_;     // tolerance of the detection of rest at equilibrium
+    long integration_substeps_; // number of integration steps per simulation step
+
+    // boolean flag which indicates whether the neuron has connections
+    bool has_connections_;
+
+    Parameters_();
+
+    void get( DictionaryDatum& ) const;
+    void set( const DictionaryDatum& );
+
+    //! Order of all members, used to share equal parameter sets
+    bool operator<( const Parameters_& ) const;
+  };
+
+  struct State_ : public Kernel_::State
+  {
+    void get( DictionaryDatum& ) const;
+    void set( const DictionaryDatum&, const Parameters_& );
+  };
+
+  struct Buffers_
+  {
+    Buffers_( glif_neuron& );
+    Buffers_( const Buffers_&, glif_neuron& );
+
+    //! Buffer incoming spikes through delay, as sum, one per receptor port
+    std::vector< RingBuffer > spikes_;
+    RingBuffer currents_; //!< Buffer incoming currents through delay,
+
+    //! Logger for all analog data
+    UniversalDataLogger< glif_neuron > logger_;
+
+    bool logging_; //!< true if a multimeter is connected
+  };
+
+  struct Variables_ : public Kernel_::Propagators
+  {
+    bool event_driven_; // update only at input changes, spikes and refractoriness
+
+    //! update loop without the inert components
+    void ( glif_neuron::*update_steps_ )( Time const&, const long, const long );
+  };
+
+  //! V_m after the given number of integration steps from the given state
+  //! and its input
+  double V_m_after_( const State_&, const double ) const;
+
+  //! First integration step in [n0, n1] after which V_m exceeds the
+  //! threshold with the current input, n1 + 1 if there is none
+  long first_crossing_( const long, const long ) const;
+
+  //! Advance the neuron in closed form by the given number of steps starting
+  //! at lag, during which the input must be constant and no spike may occur
+  void advance_( Time const&, const long, const long );
+
+  double
+  get_V_m_() const
+  {
+    return S_.V_m_;
+  }
+
+  double
+  get_AScurrents_sum_() const
+  {
+    return S_.ASCurrents_[ 0 ];
+  }
+
+  double
+  get_I_syn_() const
+  {
+    return S_.I_syn_;
+  }
+
+  glif_flyweight< Parameters_ > P_; //!< Free parameters, shared by equal sets.
+  State_ S_;                        //!< Dynamic state.
+  Variables_ V_;                    //!< Internal Variables
+  Buffers_ B_;                      //!< Buffers.
+
+  //! Mapping of recordables names to access functions
+  static RecordablesMap< glif_neuron > recordablesMap_;
+};
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline port
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::send_test_event( Node& target,
+  port receptor_type,
+  synindex,
+  bool )
+{
+  SpikeEvent e;
+  e.set_sender( *this );
+  return target.handles_test_event( e, receptor_type );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline port
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::handles_test_event( CurrentEvent&,
+  port receptor_type )
+{
+  if ( receptor_type != 0 )
+  {
+    throw UnknownReceptorType( receptor_type, get_name() );
+  }
+  return 0;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline port
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::handles_test_event( DataLoggingRequest& dlr,
+  port receptor_type )
+{
+  if ( receptor_type != 0 )
+  {
+    throw UnknownReceptorType( receptor_type, get_name() );
+  }
+
+  B_.logging_ = true;
+  return B_.logger_.connect_logging_device( dlr, recordablesMap_ );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::get_status( DictionaryDatum& d ) const
+{
+  // get our own parameter and state data
+  P_->get( d );
+  S_.get( d );
+
+  // get information managed by parent class
+  Archiving_Node::get_status( d );
+
+  ( *d )[ names::recordables ] = recordablesMap_.get_list();
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::set_status( const DictionaryDatum& d )
+{
+  Parameters_ ptmp = *P_; // temporary copy in case of errors
+  ptmp.set( d );          // throws if BadProperty
+  State_ stmp = S_;       // temporary copy in case of errors
+  stmp.set( d, ptmp );    // throws if BadProperty
+
+  // We now know that (ptmp, stmp) are consistent. We do not
+  // write them back to (P_, S_) before we are also sure that
+  // the properties to be set in the parent class are internally
+  // consistent.
+  Archiving_Node::set_status( d );
+
+  // if we get here, temporaries contain consistent set of properties
+  P_ = ptmp;
+  S_ = stmp;
+}
+
+} // namespace nest
+
+#endif
@@ -0,0 +1,799 @@
+#ifndef GLIF_NEURON_IMPL_H
+#define GLIF_NEURON_IMPL_H
+
+#include "glif_neuron.h"
+
+// C++ includes:
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+// Includes from nestkernel:
+#include "exceptions.h"
+#include "kernel_manager.h"
+#include "universal_data_logger_impl.h"
+#include "name.h"
+
+// Includes from sli:
+#include "arraydatum.h"
+#include "dict.h"
+#include "dictutils.h"
+#include "doubledatum.h"
+#include "integerdatum.h"
+#include "lockptrdatum.h"
+
+namespace nest
+{
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+RecordablesMap< glif_neuron< TReset, TASC, TThreshold, TSynapse > >
+  glif_neuron< TReset, TASC, TThreshold, TSynapse >::recordablesMap_;
+
+/* ----------------------------------------------------------------
+ * Default constructors defining default parameters and state
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::Parameters_::Parameters_()
+  : quiescence_tol_( 0.0 )
+  , integration_substeps_( 1 )
+  , has_connections_( false )
+{
+}
+
+/* ----------------------------------------------------------------
+ * Parameter and state extractions and manipulation functions
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::Parameters_::get( DictionaryDatum& d ) const
+{
+  def< double >( d, names::V_th, this->th_inf_ );
+  def< double >( d, names::g, this->G_ );
+  def< double >( d, names::E_L, this->E_L_ );
+  def< double >( d, names::C_m, this->C_m_ );
+  def< double >( d, names::t_ref, this->t_ref_ );
+
+  if ( TReset::enabled )
+  {
+    def< double >( d, "a_spike", this->a_spike_ );
+    def< double >( d, "b_spike", this->b_spike_ );
+    def< double >( d, "a_reset", this->voltage_reset_a_ );
+    def< double >( d, "b_reset", this->voltage_reset_b_ );
+  }
+  else
+  {
+    def< double >( d, names::V_reset, this->V_reset_ );
+  }
+
+  if ( TThreshold::enabled )
+  {
+    def< double >( d, "a_voltage", this->a_voltage_ );
+    def< double >( d, "b_voltage", this->b_voltage_ );
+  }
+
+  if ( TASC::enabled )
+  {
+    def< std::vector< double > >( d, Name( "asc_init" ), this->asc_init_ );
+    def< std::vector< double > >( d, Name( "k" ), this->k_ );
+    def< std::vector< double > >( d, Name( "asc_amps" ), this->asc_amps_ );
+    def< std::vector< double > >( d, Name( "r" ), this->r_ );
+  }
+
+  if ( TSynapse::enabled )
+  {
+    ArrayDatum tau_syn_ad( this->tau_syn_ );
+    def< ArrayDatum >( d, names::tau_syn, tau_syn_ad );
+  }
+
+  def< std::string >( d, "V_dynamics_method", this->V_dynamics_method_ );
+  def< std::string >( d, "spike_time_method", this->spike_time_method_ );
+  def< double >( d, "quiescence_tol", quiescence_tol_ );
+  if ( TSynapse::enabled )
+  {
+    def< double >( d, "receptor_tol", this->receptor_tol_ );
+  }
+  def< long >( d, "integration_substeps", integration_substeps_ );
+
+  if ( TSynapse::enabled )
+  {
+    def< bool >( d, names::has_connections, has_connections_ );
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::Parameters_::set( const DictionaryDatum& d )
+{
+  updateValue< double >( d, names::V_th, this->th_inf_ );
+  updateValue< double >( d, names::g, this->G_ );
+  updateValue< double >( d, names::E_L, this->E_L_ );
+  updateValue< double >( d, names::C_m, this->C_m_ );
+  updateValue< double >( d, names::t_ref, this->t_ref_ );
+
+  if ( TReset::enabled )
+  {
+    updateValue< double >( d, "a_spike", this->a_spike_ );
+    updateValue< double >( d, "b_spike", this->b_spike_ );
+    updateValue< double >( d, "a_reset", this->voltage_reset_a_ );
+    updateValue< double >( d, "b_reset", this->voltage_reset_b_ );
+  }
+  else
+  {
+    updateValue< double >( d, names::V_reset, this->V_reset_ );
+  }
+
+  if ( TThreshold::enabled )
+  {
+    updateValue< double >( d, "a_voltage", this->a_voltage_ );
+    updateValue< double >( d, "b_voltage", this->b_voltage_ );
+  }
+
+  if ( TASC::enabled )
+  {
+    updateValue< std::vector< double > >( d, Name( "asc_init" ), this->asc_init_ );
+    updateValue< std::vector< double > >( d, Name( "k" ), this->k_ );
+    updateValue< std::vector< double > >( d, Name( "asc_amps" ), this->asc_amps_ );
+    updateValue< std::vector< double > >( d, Name( "r" ), this->r_ );
+  }
+
+  if ( TSynapse::enabled )
+  {
+    updateValue< std::vector< double > >( d, "tau_syn", this->tau_syn_ );
+  }
+
+  updateValue< std::string >( d, "V_dynamics_method", this->V_dynamics_method_ );
+  updateValue< std::string >( d, "spike_time_method", this->spike_time_method_ );
+  updateValue< double >( d, "quiescence_tol", quiescence_tol_ );
+  if ( TSynapse::enabled )
+  {
+    updateValue< double >( d, "receptor_tol", this->receptor_tol_ );
+  }
+  updateValue< long >( d, "integration_substeps", integration_substeps_ );
+
+  if ( not TReset::enabled and this->V_reset_ >= this->th_inf_ )
+  {
+    throw BadProperty( "Reset potential must be smaller than threshold." );
+  }
+
+  if ( not glif_find_v_dynamics_method( this->V_dynamics_method_ ) )
+  {
+    throw BadProperty(
+      "V_dynamics_method must be one of 'linear_forward_euler', 'linear_rk2', 'linear_exact', "
+      "'linear_exact_event_driven' or 'matrix_exponential'." );
+  }
+
+  glif_spike_time_method spike_time_method;
+  if ( not glif_find_spike_time_method( this->spike_time_method_, spike_time_method ) )
+  {
+    throw BadProperty( "Spike time method must be 'linear', 'hermite' or 'exact'." );
+  }
+
+  if ( quiescence_tol_ < 0.0 )
+  {
+    throw BadProperty( "Quiescence tolerance must be non-negative." );
+  }
+
+  if ( this->receptor_tol_ < 0.0 )
+  {
+    throw BadProperty( "Receptor tolerance must be non-negative." );
+  }
+
+  if ( integration_substeps_ < 1 )
+  {
+    throw BadProperty( "Number of integration sub-steps must be at least 1." );
+  }
+
+  if ( this->C_m_ <= 0.0 )
+  {
+    throw BadProperty( "Capacitance must be strictly positive." );
+  }
+
+  if ( this->G_ <= 0.0 )
+  {
+    throw BadProperty( "Membrane conductance must be strictly positive." );
+  }
+
+  if ( this->t_ref_ <= 0.0 )
+  {
+    throw BadProperty( "Refractory time constant must be strictly positive." );
+  }
+
+  if ( TSynapse::enabled )
+  {
+    const size_t old_n_receptors = this->n_receptors_();
+    if ( updateValue< std::vector< double > >( d, "tau_syn", this->tau_syn_ ) )
+    {
+      if ( this->n_receptors_() != old_n_receptors && has_connections_ == true )
+      {
+        throw BadProperty(
+          "The neuron has connections, therefore the number of ports cannot be "
+          "reduced." );
+      }
+      for ( size_t i = 0; i < this->tau_syn_.size(); ++i )
+      {
+        if ( this->tau_syn_[ i ] <= 0 )
+        {
+          throw BadProperty( "All synaptic time constants must be strictly positive." );
+        }
+      }
+    }
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+bool
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::Parameters_::operator<( const Parameters_& p ) const
+{
+  return glif_flyweight_less(
+    std::tie( this->th_inf_, this->G_, this->E_L_, this->C_m_, this->t_ref_, this->V_reset_, this->a_spike_,
+      this->b_spike_, this->voltage_reset_a_, this->voltage_reset_b_, this->a_voltage_, this->b_voltage_,
+      this->asc_init_, this->k_, this->asc_amps_, this->r_, this->tau_syn_, this->V_dynamics_method_,
+      this->spike_time_method_, quiescence_tol_, this->receptor_tol_, integration_substeps_,
+      has_connections_ ),
+    std::tie( p.th_inf_, p.G_, p.E_L_, p.C_m_, p.t_ref_, p.V_reset_, p.a_spike_, p.b_spike_,
+      p.voltage_reset_a_, p.voltage_reset_b_, p.a_voltage_, p.b_voltage_, p.asc_init_, p.k_, p.asc_amps_,
+      p.r_, p.tau_syn_, p.V_dynamics_method_, p.spike_time_method_, p.quiescence_tol_, p.receptor_tol_,
+      p.integration_substeps_, p.has_connections_ ) );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::State_::get( DictionaryDatum& d ) const
+{
+  def< double >( d, names::V_m, this->V_m_ );
+
+  if ( TASC::enabled )
+  {
+    def< std::vector< double > >( d, Name( "ASCurrents" ), this->ASCurrents_ );
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::State_::set( const DictionaryDatum& d,
+  const Parameters_& p )
+{
+  updateValue< double >( d, names::V_m, this->V_m_ );
+  if ( TASC::enabled )
+  {
+    updateValue< std::vector< double > >( d, Name( "ASCurrents" ), this->ASCurrents_ );
+  }
+
+  this->V_m_ = p.E_L_;
+  this->ASCurrents_ = p.asc_init_;
+  this->threshold_ = p.th_inf_;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::Buffers_::Buffers_( glif_neuron& n )
+  : logger_( n )
+  , logging_( false )
+{
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::Buffers_::Buffers_( const Buffers_&, glif_neuron& n )
+  : logger_( n )
+  , logging_( false )
+{
+}
+
+/* ----------------------------------------------------------------
+ * Default and copy constructor for node
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::glif_neuron()
+  : Archiving_Node()
+  , P_()
+  , S_()
+  , B_( *this )
+{
+  recordablesMap_.create();
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::glif_neuron( const glif_neuron& n )
+  : Archiving_Node( n )
+  , P_( n.P_ )
+  , S_( n.S_ )
+  , B_( n.B_, *this )
+{
+}
+
+/* ----------------------------------------------------------------
+ * Node initialization functions
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::init_state_( const Node& proto )
+{
+  const glif_neuron& pr = downcast< glif_neuron >( proto );
+  S_ = pr.S_;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::init_buffers_()
+{
+  B_.spikes_.clear();   // includes resize
+  B_.currents_.clear(); // include resize
+  B_.logger_.reset();   // includes resize
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::calibrate()
+{
+  B_.logger_.init();
+
+  const double h = Time::get_resolution().get_ms(); // in ms
+
+  // Components that are exactly inert with the current parameters and state
+  // are left out of the update loop: after-spike currents that are zero and
+  // never triggered, and a voltage component of the threshold with
+  // a_voltage = 0, which stays zero unless b_voltage makes it undefined.
+  bool asc_active = false;
+  for ( std::size_t a = 0; a < P_->asc_amps_.size(); ++a )
+  {
+    asc_active = asc_active or P_->asc_amps_[ a ] != 0.0;
+  }
+  for ( std::size_t a = 0; a < S_.ASCurrents_.size(); ++a )
+  {
+    asc_active = asc_active or S_.ASCurrents_[ a ] != 0.0;
+  }
+  if ( not asc_active )
+  {
+    S_.ASCurrents_sum_ = 0.0;
+  }
+  const bool voltage_threshold_active = TThreshold::enabled
+    and not( P_->a_voltage_ == 0.0 and P_->b_voltage_ != 0.0 and P_->b_voltage_ != P_->G_ / P_->C_m_ );
+
+  if ( asc_active and voltage_threshold_active )
+  {
+    V_.update_steps_ = &glif_neuron::update_steps_< TASC::enabled, TThreshold::enabled >;
+  }
+  else if ( asc_active )
+  {
+    V_.update_steps_ = &glif_neuron::update_steps_< TASC::enabled, false >;
+  }
+  else if ( voltage_threshold_active )
+  {
+    V_.update_steps_ = &glif_neuron::update_steps_< false, TThreshold::enabled >;
+  }
+  else
+  {
+    V_.update_steps_ = &glif_neuron::update_steps_< false, false >;
+  }
+
+  // propagators of the kernel for the integration step, a fraction of the
+  // resolution; without closed form the event-driven method is stepped like
+  // linear_exact
+  const bool new_classes = Kernel_::calibrate( *P_, h / P_->integration_substeps_, V_, S_ );
+  V_.event_driven_ = glif_find_v_dynamics_method( P_->V_dynamics_method_ )->event_driven
+    and not TSynapse::enabled and not voltage_threshold_active;
+
+  // one spike buffer per class of receptor ports sharing a synaptic state;
+  // spikes pending for classes of other ports are discarded with their state
+  B_.spikes_.resize( V_.class_port_.size() );
+  for ( size_t i = 0; i < V_.class_port_.size(); i++ )
+  {
+    if ( new_classes )
+    {
+      B_.spikes_[ i ].clear();
+    }
+    else
+    {
+      B_.spikes_[ i ].resize();
+    }
+  }
+}
+
+/* ----------------------------------------------------------------
+ * Update and spike handling functions
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+bool
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::is_quiescent_()
+{
+  // the neuron must neither be refractory nor receive input, and it must
+  // not spike at its resting potential
+  if ( S_.t_ref_remaining_ > 0.0 || S_.I_ != 0.0 || P_->E_L_ >= P_->th_inf_
+    || std::abs( S_.V_m_ - P_->E_L_ ) > P_->quiescence_tol_ )
+  {
+    return false;
+  }
+  if ( TReset::enabled and std::abs( S_.last_spike_ ) > P_->quiescence_tol_ )
+  {
+    return false;
+  }
+  if ( TThreshold::enabled and std::abs( S_.last_voltage_ ) > P_->quiescence_tol_ )
+  {
+    return false;
+  }
+  for ( std::size_t a = 0; a < S_.ASCurrents_.size(); ++a )
+  {
+    if ( std::abs( S_.ASCurrents_[ a ] ) > P_->quiescence_tol_ )
+    {
+      return false;
+    }
+  }
+  for ( size_t k = 0; k < S_.active_receptors_.size(); k++ )
+  {
+    const size_t i = S_.active_receptors_[ k ];
+    if ( std::abs( S_.y1_[ i ] ) > P_->quiescence_tol_ || std::abs( S_.y2_[ i ] ) > P_->quiescence_tol_ )
+    {
+      return false;
+    }
+  }
+
+  // snap the state onto the equilibrium, which then does not change
+  S_.V_m_ = P_->E_L_;
+  S_.last_spike_ = 0.0;
+  S_.last_voltage_ = 0.0;
+  S_.threshold_ = P_->th_inf_;
+  std::fill( S_.ASCurrents_.begin(), S_.ASCurrents_.end(), 0.0 );
+  S_.ASCurrents_sum_ = 0.0;
+  std::fill( S_.y1_.begin(), S_.y1_.end(), 0.0 );
+  std::fill( S_.y2_.begin(), S_.y2_.end(), 0.0 );
+  S_.active_receptors_.clear();
+  S_.I_syn_ = 0.0;
+
+  return true;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+bool
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::jump_slice_( Time const& origin,
+  const long from,
+  const long to )
+{
+  // forward Euler overshoots the equilibrium for P_V_ < 0, so that V_m is
+  // not monotone as assumed by first_crossing_()
+  if ( to - from < 2 || S_.t_ref_remaining_ > 0.0 || V_.P_V_ < 0.0 )
+  {
+    return false;
+  }
+
+  // the first step is driven by S_.I_, the following ones by the buffered
+  // currents, the current of the last lag only drives the next slice
+  for ( long lag = from; lag < to - 1; ++lag )
+  {
+    if ( B_.currents_.get_value_wfr_update( lag ) != S_.I_ )
+    {
+      return false;
+    }
+  }
+
+  const long n_steps = ( to - from ) * P_->integration_substeps_;
+  if ( first_crossing_( 1, n_steps ) <= n_steps )
+  {
+    return false;
+  }
+
+  advance_( origin, from, to - from );
+  return true;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+double
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::V_m_after_( const State_& s, const double n ) const
+{
+  // all methods relax V_m geometrically towards V_inf with a = P_V_ per
+  // step, each after-spike current A_j q_j^n adds c A_j ( q_j^n - a^n ) / ( q_j - a )
+  const double a_n = std::pow( V_.P_V_, n );
+  const double c = V_.P30_;
+  const double V_inf = P_->E_L_ + s.I_ / P_->G_;
+
+  double V = V_inf + a_n * ( s.V_m_ - V_inf );
+  for ( std::size_t j = 0; j < s.ASCurrents_.size(); ++j )
+  {
+    const double q = V_.P_asc_[ j ];
+    V += c * s.ASCurrents_[ j ] * ( std::pow( q, n ) - a_n ) / ( q - V_.P_V_ );
+  }
+  return V;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+long
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::first_crossing_( const long n0, const long n1 ) const
+{
+  // Bound V_m within [n0, n1]: its relaxation towards V_inf is monotone and
+  // each after-spike current term c A_j h_j(n) satisfies
+  // a^( n1 - n0 ) h_j(n0) <= h_j(n) <= h_j(n0) + q_j^n0 min( n1 - n0, 1 / ( 1 - a ) ).
+  // The spike component of the threshold decays monotonically, so that the
+  // smaller of its end values bounds it from below. The interval is bisected
+  // until the bound of V_m stays below the bound of the threshold.
+  const double a = V_.P_V_;
+  const double a_0 = std::pow( a, n0 );
+  const double c = V_.P30_;
+  const double V_inf = P_->E_L_ + S_.I_ / P_->G_;
+  const double dV_0 = S_.V_m_ - V_inf;
+
+  double V_max = V_inf + std::max( a_0 * dV_0, std::pow( a, n1 ) * dV_0 );
+  for ( std::size_t j = 0; j < S_.ASCurrents_.size(); ++j )
+  {
+    const double q = V_.P_asc_[ j ];
+
+    // the closed form cancels for nearly equal decay rates, so that the
+    // neuron has to be updated step by step
+    if ( std::abs( q - a ) < 1e-6 )
+    {
+      return n0;
+    }
+
+    const double q_0 = std::pow( q, n0 );
+    const double h_0 = ( q_0 - a_0 ) / ( q - a );
+    if ( S_.ASCurrents_[ j ] > 0.0 )
+    {
+      V_max += c * S_.ASCurrents_[ j ]
+        * ( h_0 + q_0 * std::min( static_cast< double >( n1 - n0 ), 1.0 / ( 1.0 - a ) ) );
+    }
+    else
+    {
+      V_max += c * S_.ASCurrents_[ j ] * std::pow( a, n1 - n0 ) * h_0;
+    }
+  }
+
+  double th_min = P_->th_inf_;
+  if ( TReset::enabled )
+  {
+    th_min += std::min( S_.last_spike_ * std::pow( V_.P_th_, n0 ), S_.last_spike_ * std::pow( V_.P_th_, n1 ) );
+  }
+
+  if ( V_max <= th_min )
+  {
+    return n1 + 1;
+  }
+  if ( n0 == n1 )
+  {
+    return n0;
+  }
+
+  const long mid = n0 + ( n1 - n0 ) / 2;
+  const long n = first_crossing_( n0, mid );
+  return n <= mid ? n : first_crossing_( mid + 1, n1 );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::advance_( Time const& origin,
+  const long lag,
+  const long steps )
+{
+  // the closed form counts integration steps, the sum of the after-spike
+  // currents is the one held over the last of them
+  const long k = P_->integration_substeps_;
+  if ( B_.logging_ )
+  {
+    // fill in the recorded samples from the closed form
+    const State_ s_0 = S_;
+    for ( long n = 1; n <= steps; ++n )
+    {
+      S_.V_m_ = V_m_after_( s_0, n * k );
+      if ( TReset::enabled )
+      {
+        S_.last_spike_ = s_0.last_spike_ * std::pow( V_.P_th_, n * k );
+        S_.threshold_ = S_.last_spike_ + P_->th_inf_;
+      }
+      S_.ASCurrents_sum_ = 0.0;
+      for ( std::size_t j = 0; j < S_.ASCurrents_.size(); ++j )
+      {
+        S_.ASCurrents_sum_ += s_0.ASCurrents_[ j ] * std::pow( V_.P_asc_[ j ], n * k - 1 );
+        S_.ASCurrents_[ j ] = s_0.ASCurrents_[ j ] * std::pow( V_.P_asc_[ j ], n * k );
+      }
+      S_.I_ = B_.currents_.get_value( lag + n - 1 );
+      B_.logger_.record_data( origin.get_steps() + lag + n - 1 );
+    }
+  }
+  else
+  {
+    S_.V_m_ = V_m_after_( S_, steps * k );
+    if ( TReset::enabled )
+    {
+      S_.last_spike_ *= std::pow( V_.P_th_, steps * k );
+      S_.threshold_ = S_.last_spike_ + P_->th_inf_;
+    }
+    S_.ASCurrents_sum_ = 0.0;
+    for ( std::size_t j = 0; j < S_.ASCurrents_.size(); ++j )
+    {
+      S_.ASCurrents_[ j ] *= std::pow( V_.P_asc_[ j ], steps * k - 1 );
+      S_.ASCurrents_sum_ += S_.ASCurrents_[ j ];
+      S_.ASCurrents_[ j ] *= V_.P_asc_[ j ];
+    }
+    for ( long n = 0; n < steps; ++n )
+    {
+      S_.I_ = B_.currents_.get_value( lag + n );
+    }
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::update( Time const& origin,
+  const long from,
+  const long to )
+{
+  ( this->*V_.update_steps_ )( origin, from, to );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+template < bool ASC, bool VoltageThreshold >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::update_steps_( Time const& origin,
+  const long from,
+  const long to )
+{
+  // the closed form only bounds V_m at the ends of the steps, so that it
+  // would skip crossings within a step located by the other spike time
+  // methods, and it holds the after-spike currents over each step, unlike
+  // the full state methods
+  const bool closed_form = not VoltageThreshold and not TSynapse::enabled
+    and V_.spike_time_method_ == glif_spike_time_linear and V_.n_state_ == 0;
+  if ( closed_form and jump_slice_( origin, from, to ) )
+  {
+    return;
+  }
+
+  double v_old = S_.V_m_;
+  double th_old = S_.threshold_;
+
+  for ( long lag = from; lag < to; ++lag )
+  {
+    // event-driven mode: advance in closed form up to the next input change
+    // or threshold crossing, which are then updated step by step
+    if ( closed_form and V_.event_driven_ and S_.t_ref_remaining_ <= 0.0 )
+    {
+      long steps = 1;
+      while ( lag + steps < to && B_.currents_.get_value_wfr_update( lag + steps - 1 ) == S_.I_ )
+      {
+        ++steps;
+      }
+      // the steps whose integration steps all end below the threshold
+      const long k = P_->integration_substeps_;
+      const long n = ( first_crossing_( 1, steps * k ) - 1 ) / k;
+      if ( n > 0 )
+      {
+        advance_( origin, lag, n );
+        lag += n;
+        v_old = S_.V_m_;
+        th_old = S_.threshold_;
+        if ( lag == to )
+        {
+          break;
+        }
+      }
+    }
+
+    // quiescence fast path: at rest and without input the state does not
+    // change, so that only the input buffers are read and the state recorded
+    if ( is_quiescent_() )
+    {
+      for ( size_t i = 0; i < S_.y1_.size(); i++ )
+      {
+        Kernel_::add_spikes( V_, S_, i, B_.spikes_[ i ].get_value( lag ) );
+      }
+      S_.I_ = B_.currents_.get_value( lag );
+      B_.logger_.record_data( origin.get_steps() + lag );
+      v_old = S_.V_m_;
+      th_old = S_.threshold_;
+      continue;
+    }
+
+    // integrate the step in integration steps of V_.h_, of which sub are
+    // left after the current one
+    for ( long sub = P_->integration_substeps_ - 1; sub >= 0; --sub )
+    {
+      double spike_offset;
+      bool spiked;
+      if ( V_.spike_time_method_ == glif_spike_time_linear )
+      {
+        spiked = Kernel_::template step< ASC, VoltageThreshold >( *P_, V_, S_, v_old, th_old, spike_offset );
+      }
+      else
+      {
+        const typename Kernel_::State s_start = S_;
+        spiked = Kernel_::template step< ASC, VoltageThreshold >( *P_, V_, S_, v_old, th_old, spike_offset );
+        spiked =
+          Kernel_::template locate_crossing< ASC, VoltageThreshold >( *P_, V_, s_start, S_, spiked, spike_offset );
+      }
+      if ( spiked )
+      {
+        // record the exact time during this step that the neuron crossed the threshold
+        spike_offset += sub * V_.h_;
+        set_spiketime( Time::step( origin.get_steps() + lag + 1 ), spike_offset );
+        SpikeEvent se;
+        se.set_offset( spike_offset );
+        kernel().event_delivery_manager.send( *this, se, lag );
+      }
+
+      v_old = S_.V_m_;
+      th_old = S_.threshold_;
+    }
+
+    // Apply spikes delivered in this step: The spikes arriving at T+1 have an
+    // immediate effect on the state of the neuron
+    for ( size_t i = 0; i < S_.y1_.size(); i++ )
+    {
+      Kernel_::add_spikes( V_, S_, i, B_.spikes_[ i ].get_value( lag ) );
+    }
+
+    // Update any external currents
+    S_.I_ = B_.currents_.get_value( lag );
+
+    // Save voltage
+    B_.logger_.record_data( origin.get_steps() + lag );
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+port
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::handles_test_event( SpikeEvent&, rport receptor_type )
+{
+  if ( not TSynapse::enabled )
+  {
+    if ( receptor_type != 0 )
+    {
+      throw UnknownReceptorType( receptor_type, get_name() );
+    }
+    return 0;
+  }
+
+  if ( receptor_type <= 0 || receptor_type > static_cast< port >( P_->n_receptors_() ) )
+  {
+    throw IncompatibleReceptorType( receptor_type, get_name(), "SpikeEvent" );
+  }
+
+  if ( not P_->has_connections_ )
+  {
+    Parameters_ ptmp = *P_;
+    ptmp.has_connections_ = true;
+    P_ = ptmp;
+  }
+  return receptor_type;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::handle( SpikeEvent& e )
+{
+  assert( e.get_delay() > 0 );
+
+  // without synaptic currents, spikes have no effect
+  if ( TSynapse::enabled )
+  {
+    B_.spikes_[ V_.receptor_class_[ e.get_rport() - 1 ] ].add_value(
+      e.get_rel_delivery_steps( kernel().simulation_manager.get_slice_origin() ),
+      e.get_weight() * e.get_multiplicity() );
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::handle( CurrentEvent& e )
+{
+  assert( e.get_delay() > 0 );
+
+  B_.currents_.add_value(
+    e.get_rel_delivery_steps( kernel().simulation_manager.get_slice_origin() ),
+    e.get_weight() * e.get_current() );
+}
+
+// Do not move this function as inline to h-file. It depends on
+// universal_data_logger_impl.h being included here.
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron< TReset, TASC, TThreshold, TSynapse >::handle( DataLoggingRequest& e )
+{
+  B_.logger_.handle( e ); // the logger does this for us
+}
+
+} // namespace nest
+
+#endif
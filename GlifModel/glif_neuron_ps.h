@@ -0,0 +1,263 @@
+#ifndef GLIF_NEURON_PS_H
+#define GLIF_NEURON_PS_H
+
+// C++ includes:
+#include <vector>
+
+// Includes from nestkernel:
+#include "archiving_node.h"
+#include "connection.h"
+#include "event.h"
+#include "nest_types.h"
+#include "ring_buffer.h"
+#include "slice_ring_buffer.h"
+#include "universal_data_logger.h"
+
+// Includes from sli:
+#include "dictdatum.h"
+
+#include "glif_flyweight.h"
+#include "glif_kernel.h"
+
+namespace nest
+{
+
+/**
+ * Precise spike timing implementation of the current based GLIF models [1]
+ * with alpha-function shaped synaptic currents, for the mechanisms selected
+ * by the policies of glif_kernel. Each model is a typedef of an
+ * instantiation, named after the grid-based model with the suffix _ps.
+ *
+ * Incoming spike events are applied at their offsets within the step
+ * instead of at its end. The neuron is integrated exactly from event to
+ * event with propagators for the length of each sub-step, V_m with the
+ * linear exact method. A threshold crossing detected at the end of a
+ * sub-step is located by root finding on the exact solution, and the
+ * refractory period starts and ends at the crossing and t_ref later, so
+ * that neither the spike times nor the reset depend on the resolution.
+ * Currents are applied at the step boundaries as in the grid-based models.
+ *
+ * References:
+ *   [1] Teeter C, Iyer R, Menon V, Gouwens N, Feng D, Berg J, Szafer A,
+ *       Cain N, Zeng H, Hawrylycz M, Koch C, & Mihalas S (2018)
+ *       Generalized leaky integrate-and-fire models classify multiple neuron
+ *       types. Nature Communications 9:709.
+ */
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+class glif_neuron_ps : public Archiving_Node
+{
+public:
+  glif_neuron_ps();
+
+  glif_neuron_ps( const glif_neuron_ps& );
+
+  using Node::handle;
+  using Node::handles_test_event;
+
+  port send_test_event( Node&, port, synindex, bool );
+
+  void handle( SpikeEvent& );
+  void handle( CurrentEvent& );
+  void handle( DataLoggingRequest& );
+
+  port handles_test_event( SpikeEvent&, port );
+  port handles_test_event( CurrentEvent&, port );
+  port handles_test_event( DataLoggingRequest&, port );
+
+  bool is_off_grid() const // uses off_grid events
+  {
+    return true;
+  }
+
+  void get_status( DictionaryDatum& ) const;
+  void set_status( const DictionaryDatum& );
+
+private:
+  typedef glif_kernel< TReset, TASC, TThreshold, TSynapse > Kernel_;
+
+  //! Reset state of neuron.
+  void init_state_( const Node& proto );
+
+  //! Reset internal buffers of neuron.
+  void init_buffers_();
+
+  //! Initialize auxiliary quantities, leave parameters and state untouched.
+  void calibrate();
+
+  //! Take neuron through given time interval
+  void update( Time const&, const long, const long );
+
+  //! Integrate the neuron exactly over dt in ms, starting t in ms before the
+  //! end of the step at lag, and send the spikes of the threshold crossings
+  void propagate_( Time const&, const long, const double, const double );
+
+  //! Send a spike at the given offset before the end of the step at lag
+  void emit_spike_( Time const&, const long, const double );
+
+  // The next two classes need to be friends to access the State_ class/member
+  friend class RecordablesMap< glif_neuron_ps >;
+  friend class UniversalDataLogger< glif_neuron_ps >;
+
+  struct Parameters_ : public Kernel_::Parameters
+  {
+    // boolean flag which indicates whether the neuron has connections
+    bool has_connections_;
+
+    Parameters_();
+
+    void get( DictionaryDatum& ) const;
+    void set( const DictionaryDatum& );
+
+    //! Order of all members, used to share equal parameter sets
+    bool operator<( const Parameters_& ) const;
+  };
+
+  struct State_ : public Kernel_::State
+  {
+    void get( DictionaryDatum& ) const;
+    void set( const DictionaryDatum&, const Parameters_& );
+  };
+
+  //! Spike input of one receptor class at an offset within the step
+  struct Spike_
+  {
+    double offset_; // time before the end of the step in ms
+    size_t port_;   // receptor class, starting at 0
+    double weight_; // summed weight of the spikes at the offset
+
+    //! Order of arrival, the largest offset first
+    bool operator<( const Spike_& ) const;
+  };
+
+  struct Buffers_
+  {
+    Buffers_( glif_neuron_ps& );
+    Buffers_( const Buffers_&, glif_neuron_ps& );
+
+    //! Queue incoming spikes with their offsets, one per receptor port
+    std::vector< SliceRingBuffer > spikes_;
+    RingBuffer currents_; //!< Buffer incoming currents through delay,
+
+    //! Spikes of all ports arriving in the current step, in order of arrival
+    std::vector< Spike_ > step_spikes_;
+
+    //! Logger for all analog data
+    UniversalDataLogger< glif_neuron_ps > logger_;
+  };
+
+  //! Propagators of the step of the resolution
+  struct Variables_ : public Kernel_::Propagators
+  {
+    //! Propagators of the sub-steps between spikes, a copy made by
+    //! calibrate() whose storage they reuse
+    typename Kernel_::Propagators sub_step_;
+  };
+
+  double
+  get_V_m_() const
+  {
+    return S_.V_m_;
+  }
+
+  double
+  get_AScurrents_sum_() const
+  {
+    return S_.ASCurrents_[ 0 ];
+  }
+
+  double
+  get_I_syn_() const
+  {
+    return S_.I_syn_;
+  }
+
+  glif_flyweight< Parameters_ > P_; //!< Free parameters, shared by equal sets.
+  State_ S_;                        //!< Dynamic state.
+  Variables_ V_;                    //!< Internal Variables
+  Buffers_ B_;                      //!< Buffers.
+
+  //! Mapping of recordables names to access functions
+  static RecordablesMap< glif_neuron_ps > recordablesMap_;
+};
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline bool
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::Spike_::operator<( const Spike_& s ) const
+{
+  return offset_ > s.offset_;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline port
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::send_test_event( Node& target,
+  port receptor_type,
+  synindex,
+  bool )
+{
+  SpikeEvent e;
+  e.set_sender( *this );
+  return target.handles_test_event( e, receptor_type );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline port
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::handles_test_event( CurrentEvent&,
+  port receptor_type )
+{
+  if ( receptor_type != 0 )
+  {
+    throw UnknownReceptorType( receptor_type, get_name() );
+  }
+  return 0;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline port
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::handles_test_event( DataLoggingRequest& dlr,
+  port receptor_type )
+{
+  if ( receptor_type != 0 )
+  {
+    throw UnknownReceptorType( receptor_type, get_name() );
+  }
+
+  return B_.logger_.connect_logging_device( dlr, recordablesMap_ );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::get_status( DictionaryDatum& d ) const
+{
+  // get our own parameter and state data
+  P_->get( d );
+  S_.get( d );
+
+  // get information managed by parent class
+  Archiving_Node::get_status( d );
+
+  ( *d )[ names::recordables ] = recordablesMap_.get_list();
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::set_status( const DictionaryDatum& d )
+{
+  Parameters_ ptmp = *P_; // temporary copy in case of errors
+  ptmp.set( d );          // throws if BadProperty
+  State_ stmp = S_;       // temporary copy in case of errors
+  stmp.set( d, ptmp );    // throws if BadProperty
+
+  // We now know that (ptmp, stmp) are consistent. We do not
+  // write them back to (P_, S_) before we are also sure that
+  // the properties to be set in the parent class are internally
+  // consistent.
+  Archiving_Node::set_status( d );
+
+  // if we get here, temporaries contain consistent set of properties
+  P_ = ptmp;
+  S_ = stmp;
+}
+
+} // namespace nest
+
+#endif
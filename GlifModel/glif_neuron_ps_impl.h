@@ -0,0 +1,475 @@
+#ifndef GLIF_NEURON_PS_IMPL_H
+#define GLIF_NEURON_PS_IMPL_H
+
+#include "glif_neuron_ps.h"
+
+// C++ includes:
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <tuple>
+
+// Includes from nestkernel:
+#include "exceptions.h"
+#include "kernel_manager.h"
+#include "universal_data_logger_impl.h"
+#include "name.h"
+
+// Includes from sli:
+#include "arraydatum.h"
+#include "dict.h"
+#include "dictutils.h"
+#include "doubledatum.h"
+#include "integerdatum.h"
+#include "lockptrdatum.h"
+
+namespace nest
+{
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+RecordablesMap< glif_neuron_ps< TReset, TASC, TThreshold, TSynapse > >
+  glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::recordablesMap_;
+
+/* ----------------------------------------------------------------
+ * Default constructors defining default parameters and state
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::Parameters_::Parameters_()
+  : has_connections_( false )
+{
+  // sub-steps of any length are integrated exactly
+  this->V_dynamics_method_ = "linear_exact";
+}
+
+/* ----------------------------------------------------------------
+ * Parameter and state extractions and manipulation functions
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::Parameters_::get( DictionaryDatum& d ) const
+{
+  def< double >( d, names::V_th, this->th_inf_ );
+  def< double >( d, names::g, this->G_ );
+  def< double >( d, names::E_L, this->E_L_ );
+  def< double >( d, names::C_m, this->C_m_ );
+  def< double >( d, names::t_ref, this->t_ref_ );
+
+  if ( TReset::enabled )
+  {
+    def< double >( d, "a_spike", this->a_spike_ );
+    def< double >( d, "b_spike", this->b_spike_ );
+    def< double >( d, "a_reset", this->voltage_reset_a_ );
+    def< double >( d, "b_reset", this->voltage_reset_b_ );
+  }
+  else
+  {
+    def< double >( d, names::V_reset, this->V_reset_ );
+  }
+
+  if ( TThreshold::enabled )
+  {
+    def< double >( d, "a_voltage", this->a_voltage_ );
+    def< double >( d, "b_voltage", this->b_voltage_ );
+  }
+
+  if ( TASC::enabled )
+  {
+    def< std::vector< double > >( d, Name( "asc_init" ), this->asc_init_ );
+    def< std::vector< double > >( d, Name( "k" ), this->k_ );
+    def< std::vector< double > >( d, Name( "asc_amps" ), this->asc_amps_ );
+    def< std::vector< double > >( d, Name( "r" ), this->r_ );
+  }
+
+  ArrayDatum tau_syn_ad( this->tau_syn_ );
+  def< ArrayDatum >( d, names::tau_syn, tau_syn_ad );
+  def< double >( d, "receptor_tol", this->receptor_tol_ );
+
+  def< bool >( d, names::has_connections, has_connections_ );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::Parameters_::set( const DictionaryDatum& d )
+{
+  updateValue< double >( d, names::V_th, this->th_inf_ );
+  updateValue< double >( d, names::g, this->G_ );
+  updateValue< double >( d, names::E_L, this->E_L_ );
+  updateValue< double >( d, names::C_m, this->C_m_ );
+  updateValue< double >( d, names::t_ref, this->t_ref_ );
+
+  if ( TReset::enabled )
+  {
+    updateValue< double >( d, "a_spike", this->a_spike_ );
+    updateValue< double >( d, "b_spike", this->b_spike_ );
+    updateValue< double >( d, "a_reset", this->voltage_reset_a_ );
+    updateValue< double >( d, "b_reset", this->voltage_reset_b_ );
+  }
+  else
+  {
+    updateValue< double >( d, names::V_reset, this->V_reset_ );
+  }
+
+  if ( TThreshold::enabled )
+  {
+    updateValue< double >( d, "a_voltage", this->a_voltage_ );
+    updateValue< double >( d, "b_voltage", this->b_voltage_ );
+  }
+
+  if ( TASC::enabled )
+  {
+    updateValue< std::vector< double > >( d, Name( "asc_init" ), this->asc_init_ );
+    updateValue< std::vector< double > >( d, Name( "k" ), this->k_ );
+    updateValue< std::vector< double > >( d, Name( "asc_amps" ), this->asc_amps_ );
+    updateValue< std::vector< double > >( d, Name( "r" ), this->r_ );
+  }
+
+  updateValue< double >( d, "receptor_tol", this->receptor_tol_ );
+
+  if ( not TReset::enabled and this->V_reset_ >= this->th_inf_ )
+  {
+    throw BadProperty( "Reset potential must be smaller than threshold." );
+  }
+
+  if ( this->receptor_tol_ < 0.0 )
+  {
+    throw BadProperty( "Receptor tolerance must be non-negative." );
+  }
+
+  if ( this->C_m_ <= 0.0 )
+  {
+    throw BadProperty( "Capacitance must be strictly positive." );
+  }
+
+  if ( this->G_ <= 0.0 )
+  {
+    throw BadProperty( "Membrane conductance must be strictly positive." );
+  }
+
+  if ( this->t_ref_ <= 0.0 )
+  {
+    throw BadProperty( "Refractory time constant must be strictly positive." );
+  }
+
+  const size_t old_n_receptors = this->n_receptors_();
+  if ( updateValue< std::vector< double > >( d, "tau_syn", this->tau_syn_ ) )
+  {
+    if ( this->n_receptors_() != old_n_receptors && has_connections_ == true )
+    {
+      throw BadProperty(
+        "The neuron has connections, therefore the number of ports cannot be "
+        "reduced." );
+    }
+    for ( size_t i = 0; i < this->tau_syn_.size(); ++i )
+    {
+      if ( this->tau_syn_[ i ] <= 0 )
+      {
+        throw BadProperty( "All synaptic time constants must be strictly positive." );
+      }
+    }
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+bool
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::Parameters_::operator<( const Parameters_& p ) const
+{
+  return glif_flyweight_less(
+    std::tie( this->th_inf_, this->G_, this->E_L_, this->C_m_, this->t_ref_, this->V_reset_, this->a_spike_,
+      this->b_spike_, this->voltage_reset_a_, this->voltage_reset_b_, this->a_voltage_, this->b_voltage_,
+      this->asc_init_, this->k_, this->asc_amps_, this->r_, this->tau_syn_, this->V_dynamics_method_,
+      this->spike_time_method_, this->receptor_tol_, has_connections_ ),
+    std::tie( p.th_inf_, p.G_, p.E_L_, p.C_m_, p.t_ref_, p.V_reset_, p.a_spike_, p.b_spike_,
+      p.voltage_reset_a_, p.voltage_reset_b_, p.a_voltage_, p.b_voltage_, p.asc_init_, p.k_, p.asc_amps_,
+      p.r_, p.tau_syn_, p.V_dynamics_method_, p.spike_time_method_, p.receptor_tol_, p.has_connections_ ) );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::State_::get( DictionaryDatum& d ) const
+{
+  def< double >( d, names::V_m, this->V_m_ );
+
+  if ( TASC::enabled )
+  {
+    def< std::vector< double > >( d, Name( "ASCurrents" ), this->ASCurrents_ );
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::State_::set( const DictionaryDatum& d,
+  const Parameters_& p )
+{
+  updateValue< double >( d, names::V_m, this->V_m_ );
+  if ( TASC::enabled )
+  {
+    updateValue< std::vector< double > >( d, Name( "ASCurrents" ), this->ASCurrents_ );
+  }
+
+  this->V_m_ = p.E_L_;
+  this->ASCurrents_ = p.asc_init_;
+  this->threshold_ = p.th_inf_;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::Buffers_::Buffers_( glif_neuron_ps& n )
+  : logger_( n )
+{
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::Buffers_::Buffers_( const Buffers_&, glif_neuron_ps& n )
+  : logger_( n )
+{
+}
+
+/* ----------------------------------------------------------------
+ * Default and copy constructor for node
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::glif_neuron_ps()
+  : Archiving_Node()
+  , P_()
+  , S_()
+  , B_( *this )
+{
+  recordablesMap_.create();
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::glif_neuron_ps( const glif_neuron_ps& n )
+  : Archiving_Node( n )
+  , P_( n.P_ )
+  , S_( n.S_ )
+  , B_( n.B_, *this )
+{
+}
+
+/* ----------------------------------------------------------------
+ * Node initialization functions
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::init_state_( const Node& proto )
+{
+  const glif_neuron_ps& pr = downcast< glif_neuron_ps >( proto );
+  S_ = pr.S_;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::init_buffers_()
+{
+  B_.spikes_.clear();   // includes resize
+  B_.currents_.clear(); // include resize
+  B_.logger_.reset();   // includes resize
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::calibrate()
+{
+  B_.logger_.init();
+
+  const double h = Time::get_resolution().get_ms(); // in ms
+  const bool new_classes = Kernel_::calibrate( *P_, h, V_, S_ );
+  V_.sub_step_ = V_;
+
+  // one spike buffer per class of receptor ports sharing a synaptic state;
+  // spikes pending for classes of other ports are discarded with their state
+  B_.spikes_.resize( V_.class_port_.size() );
+  for ( size_t i = 0; i < V_.class_port_.size(); i++ )
+  {
+    if ( new_classes )
+    {
+      B_.spikes_[ i ].clear();
+    }
+    else
+    {
+      B_.spikes_[ i ].resize();
+    }
+  }
+}
+
+/* ----------------------------------------------------------------
+ * Update and spike handling functions
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::update( Time const& origin, const long from, const long to )
+{
+  // at start of slice, tell the input queues to prepare for delivery
+  if ( from == 0 )
+  {
+    for ( size_t i = 0; i < B_.spikes_.size(); i++ )
+    {
+      B_.spikes_[ i ].prepare_delivery();
+    }
+  }
+
+  for ( long lag = from; lag < to; ++lag )
+  {
+    const long T = origin.get_steps() + lag;
+
+    // collect the spikes of all ports arriving during this step
+    B_.step_spikes_.clear();
+    for ( size_t i = 0; i < B_.spikes_.size(); i++ )
+    {
+      Spike_ spike;
+      spike.port_ = i;
+      bool end_of_refract;
+      while ( B_.spikes_[ i ].get_next_spike( T, true, spike.offset_, spike.weight_, end_of_refract ) )
+      {
+        B_.step_spikes_.push_back( spike );
+      }
+    }
+    std::stable_sort( B_.step_spikes_.begin(), B_.step_spikes_.end() );
+
+    // integrate from spike to spike, each applied at its offset
+    double last_offset = V_.h_;
+    for ( size_t k = 0; k < B_.step_spikes_.size(); ++k )
+    {
+      const Spike_& spike = B_.step_spikes_[ k ];
+      propagate_( origin, lag, last_offset, last_offset - spike.offset_ );
+      Kernel_::add_spikes( V_, S_, spike.port_, spike.weight_ );
+      last_offset = spike.offset_;
+    }
+
+    // and across the remainder of the step
+    propagate_( origin, lag, last_offset, last_offset );
+
+    // Update any external currents
+    S_.I_ = B_.currents_.get_value( lag );
+
+    // Save voltage
+    B_.logger_.record_data( origin.get_steps() + lag );
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::propagate_( Time const& origin,
+  const long lag,
+  const double t,
+  const double dt )
+{
+  if ( dt <= 0.0 )
+  {
+    return;
+  }
+
+  // the refractory period ends within the sub-step: reset V_m at its end
+  if ( S_.t_ref_remaining_ > 0.0 and S_.t_ref_remaining_ < dt )
+  {
+    const double t_ref_remaining = S_.t_ref_remaining_;
+    propagate_( origin, lag, t, t_ref_remaining );
+    propagate_( origin, lag, t - t_ref_remaining, dt - t_ref_remaining );
+    return;
+  }
+
+  if ( dt != V_.h_ )
+  {
+    Kernel_::propagators( *P_, dt, V_.sub_step_ );
+  }
+  const typename Kernel_::Propagators& p_dt = dt != V_.h_ ? V_.sub_step_ : V_;
+
+  const State_ s_start = S_;
+  double spike_offset;
+  if ( not Kernel_::template step< TASC::enabled, TThreshold::enabled >(
+         *P_, p_dt, S_, S_.V_m_, S_.threshold_, spike_offset ) )
+  {
+    return;
+  }
+
+  // V_m is above the threshold at the end of the sub-step: integrate up to
+  // the crossing, where the refractory period starts, and across the rest
+  // of the sub-step
+  Kernel_::crossing_basis( *P_, p_dt, s_start, dt );
+  const double t_cross = Kernel_::template find_crossing< TASC::enabled, TThreshold::enabled >(
+    *P_, p_dt, s_start, dt, S_.V_m_ - S_.threshold_ );
+  S_ = s_start;
+  if ( t_cross > 0.0 )
+  {
+    Kernel_::propagators( *P_, t_cross, V_.sub_step_ );
+    Kernel_::template step< TASC::enabled, TThreshold::enabled >(
+      *P_, V_.sub_step_, S_, S_.V_m_, S_.threshold_, spike_offset );
+  }
+  S_.t_ref_remaining_ = V_.t_ref_total_;
+  emit_spike_( origin, lag, t - t_cross );
+
+  propagate_( origin, lag, t - t_cross, dt - t_cross );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::emit_spike_( Time const& origin,
+  const long lag,
+  const double spike_offset )
+{
+  set_spiketime( Time::step( origin.get_steps() + lag + 1 ), spike_offset );
+  SpikeEvent se;
+  se.set_offset( spike_offset );
+  kernel().event_delivery_manager.send( *this, se, lag );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+port
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::handles_test_event( SpikeEvent&, rport receptor_type )
+{
+  if ( receptor_type <= 0 || receptor_type > static_cast< port >( P_->n_receptors_() ) )
+  {
+    throw IncompatibleReceptorType( receptor_type, get_name(), "SpikeEvent" );
+  }
+
+  if ( not P_->has_connections_ )
+  {
+    Parameters_ ptmp = *P_;
+    ptmp.has_connections_ = true;
+    P_ = ptmp;
+  }
+  return receptor_type;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::handle( SpikeEvent& e )
+{
+  assert( e.get_delay() > 0 );
+
+  // the spike arrives during the step ending at its stamp plus delay
+  const long Tdeliver = e.get_stamp().get_steps() + e.get_delay() - 1;
+  B_.spikes_[ V_.receptor_class_[ e.get_rport() - 1 ] ].add_spike(
+    e.get_rel_delivery_steps( kernel().simulation_manager.get_slice_origin() ),
+    Tdeliver,
+    e.get_offset(),
+    e.get_weight() * e.get_multiplicity() );
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::handle( CurrentEvent& e )
+{
+  assert( e.get_delay() > 0 );
+
+  B_.currents_.add_value(
+    e.get_rel_delivery_steps( kernel().simulation_manager.get_slice_origin() ),
+    e.get_weight() * e.get_current() );
+}
+
+// Do not move this function as inline to h-file. It depends on
+// universal_data_logger_impl.h being included here.
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_neuron_ps< TReset, TASC, TThreshold, TSynapse >::handle( DataLoggingRequest& e )
+{
+  B_.logger_.handle( e ); // the logger does this for us
+}
+
+} // namespace nest
+
+#endif
@@ -13,6 +13,12 @@
 #include "glif_lif_asc_psc.h"
 #include "glif_lif_r_asc_psc.h"
 #include "glif_lif_r_asc_a_psc.h"
+#include "glif_lif_psc_population.h"
+#include "glif_lif_psc_ps.h"
+#include "glif_lif_r_psc_ps.h"
+#include "glif_lif_asc_psc_ps.h"
+#include "glif_lif_r_asc_psc_ps.h"
+#include "glif_lif_r_asc_a_psc_ps.h"
 #include "glif_lif_cond.h"
 #include "glif_lif_r_cond.h"
 #include "glif_lif_asc_cond.h"
@@ -71,6 +77,12 @@ void nest::GlifModules::init(SLIInterpreter *i) {
   nest::kernel().model_manager.register_node_model<glif_lif_asc_psc>("glif_lif_asc_psc");
   nest::kernel().model_manager.register_node_model<glif_lif_r_asc_psc>("glif_lif_r_asc_psc");
   nest::kernel().model_manager.register_node_model<glif_lif_r_asc_a_psc>("glif_lif_r_asc_a_psc");
+  nest::kernel().model_manager.register_node_model<glif_lif_psc_population>("glif_lif_psc_population");
+  nest::kernel().model_manager.register_node_model<glif_lif_psc_ps>("glif_lif_psc_ps");
+  nest::kernel().model_manager.register_node_model<glif_lif_r_psc_ps>("glif_lif_r_psc_ps");
+  nest::kernel().model_manager.register_node_model<glif_lif_asc_psc_ps>("glif_lif_asc_psc_ps");
+  nest::kernel().model_manager.register_node_model<glif_lif_r_asc_psc_ps>("glif_lif_r_asc_psc_ps");
+  nest::kernel().model_manager.register_node_model<glif_lif_r_asc_a_psc_ps>("glif_lif_r_asc_a_psc_ps");
   nest::kernel().model_manager.register_node_model<glif_lif_cond>("glif_lif_cond");
   nest::kernel().model_manager.register_node_model<glif_lif_r_cond>("glif_lif_r_cond");
   nest::kernel().model_manager.register_node_model<glif_lif_asc_cond>("glif_lif_asc_cond");
@@ -0,0 +1,89 @@
+#ifndef GLIF_ACTIVE_RECEPTORS_H
+#define GLIF_ACTIVE_RECEPTORS_H
+
+// C++ includes:
+#include <cstddef>
+
+#include "glif_small_vector.h"
+
+namespace nest
+{
+
+/**
+ * Receptor ports of a neuron whose synaptic state is not zero, in ascending
+ * order. The update loops of the psc and cond models iterate over these
+ * ports only, so that ports without recent spikes cost nothing. A port is
+ * inserted when a spike arrives at it and dropped by the loop that
+ * propagates it once its synaptic state has decayed to within receptor_tol
+ * of zero, which is then set to zero. The order keeps the sums over the
+ * ports those over all ports, to which the inactive ones add exactly zero.
+ * In the models that merge ports of equal kinetics, see glif_receptor_classes,
+ * the entries are classes of ports.
+ */
+class glif_active_receptors
+{
+public:
+  size_t
+  size() const
+  {
+    return ports_.size();
+  }
+
+  bool
+  empty() const
+  {
+    return ports_.empty();
+  }
+
+  size_t& operator[]( size_t k )
+  {
+    return ports_[ k ];
+  }
+
+  size_t operator[]( size_t k ) const
+  {
+    return ports_[ k ];
+  }
+
+  //! Adds port i in order, unless it is active already
+  void
+  insert( size_t i )
+  {
+    size_t k = ports_.size();
+    while ( k > 0 and ports_[ k - 1 ] > i )
+    {
+      --k;
+    }
+    if ( k > 0 and ports_[ k - 1 ] == i )
+    {
+      return;
+    }
+    ports_.resize( ports_.size() + 1 );
+    for ( size_t l = ports_.size() - 1; l > k; --l )
+    {
+      ports_[ l ] = ports_[ l - 1 ];
+    }
+    ports_[ k ] = i;
+  }
+
+  //! Keeps the first n ports, into which a loop over the ports has moved
+  //! those that stay active
+  void
+  truncate( size_t n )
+  {
+    ports_.resize( n );
+  }
+
+  void
+  clear()
+  {
+    ports_.clear();
+  }
+
+private:
+  glif_small_vector< size_t, 4 > ports_;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,184 @@
+#include "glif_kernel.h"
+
+// C++ includes:
+#include <algorithm>
+#include <cmath>
+
+namespace nest
+{
+
+/* ----------------------------------------------------------------
+ * Propagators of the synaptic currents to V_m, as in NEST's
+ * propagator_stability, which the kernel does not depend on
+ * ---------------------------------------------------------------- */
+
+double
+glif_propagator_31( const double tau_syn, const double tau, const double C, const double h )
+{
+  const double P31_linear = 1.0 / ( 3.0 * C * tau * tau ) * h * h * h * ( tau_syn - tau ) * std::exp( -h / tau );
+  const double P31 = 1.0 / C
+    * ( std::exp( -h / tau_syn ) * std::expm1( -h / tau + h / tau_syn ) / ( tau / tau_syn - 1.0 ) * tau
+        - h * std::exp( -h / tau_syn ) )
+    / ( -1.0 / tau + 1.0 / tau_syn );
+  const double P31_singular = h * h / 2.0 / C * std::exp( -h / tau );
+  const double dev_P31 = std::abs( P31 - P31_singular );
+
+  if ( tau == tau_syn || ( std::abs( tau - tau_syn ) < 0.1 && dev_P31 > 2.0 * std::abs( P31_linear ) ) )
+  {
+    return P31_singular;
+  }
+  else
+  {
+    return P31;
+  }
+}
+
+double
+glif_propagator_32( const double tau_syn, const double tau, const double C, const double h )
+{
+  const double P32_linear = 1.0 / ( 2.0 * C * tau * tau ) * h * h * ( tau_syn - tau ) * std::exp( -h / tau );
+  const double P32_singular = h / C * std::exp( -h / tau );
+  const double P32 =
+    -tau / ( C * ( 1.0 - tau / tau_syn ) ) * std::exp( -h / tau_syn ) * std::expm1( h * ( 1.0 / tau_syn - 1.0 / tau ) );
+
+  const double dev_P32 = std::abs( P32 - P32_singular );
+
+  if ( tau == tau_syn || ( std::abs( tau - tau_syn ) < 0.1 && dev_P32 > 2.0 * std::abs( P32_linear ) ) )
+  {
+    return P32_singular;
+  }
+  else
+  {
+    return P32;
+  }
+}
+
+/* ----------------------------------------------------------------
+ * Matrix exponential of the propagator of the linear state
+ * ---------------------------------------------------------------- */
+
+void
+glif_matrix_exponential( const std::vector< double >& A,
+  const size_t n,
+  const double t,
+  std::vector< double >& E,
+  std::vector< double >& work )
+{
+  // scale A t by 2^-squarings to a norm of at most 1/2, for which the Taylor
+  // series converges within a few terms
+  double norm = 0.0;
+  for ( size_t r = 0; r < n; ++r )
+  {
+    double row = 0.0;
+    for ( size_t c = 0; c < n; ++c )
+    {
+      row += std::abs( A[ r * n + c ] );
+    }
+    norm = std::max( norm, row * std::abs( t ) );
+  }
+  int squarings = 0;
+  if ( norm > 0.5 )
+  {
+    squarings = static_cast< int >( std::ceil( std::log2( norm / 0.5 ) ) );
+  }
+  const double scale = std::ldexp( t, -squarings );
+
+  // E = sum_k ( A scale )^k / k!
+  work.resize( 2 * n * n );
+  double* term = &work[ 0 ];
+  double* product = &work[ n * n ];
+  E.assign( n * n, 0.0 );
+  std::fill( term, term + n * n, 0.0 );
+  for ( size_t r = 0; r < n; ++r )
+  {
+    E[ r * n + r ] = 1.0;
+    term[ r * n + r ] = 1.0;
+  }
+  for ( int order = 1; order <= 30; ++order )
+  {
+    double term_max = 0.0;
+    for ( size_t r = 0; r < n; ++r )
+    {
+      for ( size_t c = 0; c < n; ++c )
+      {
+        double x = 0.0;
+        for ( size_t j = 0; j < n; ++j )
+        {
+          x += term[ r * n + j ] * A[ j * n + c ];
+        }
+        product[ r * n + c ] = x * scale / order;
+        term_max = std::max( term_max, std::abs( product[ r * n + c ] ) );
+      }
+    }
+    std::swap( term, product );
+    for ( size_t i = 0; i < n * n; ++i )
+    {
+      E[ i ] += term[ i ];
+    }
+    if ( term_max < 1e-18 )
+    {
+      break;
+    }
+  }
+
+  // exp( A t ) = exp( A scale )^( 2^squarings )
+  for ( int i = 0; i < squarings; ++i )
+  {
+    for ( size_t r = 0; r < n; ++r )
+    {
+      for ( size_t c = 0; c < n; ++c )
+      {
+        double x = 0.0;
+        for ( size_t j = 0; j < n; ++j )
+        {
+          x += E[ r * n + j ] * E[ j * n + c ];
+        }
+        product[ r * n + c ] = x;
+      }
+    }
+    std::copy( product, product + n * n, E.begin() );
+  }
+}
+
+/* ----------------------------------------------------------------
+ * Spike time methods
+ * ---------------------------------------------------------------- */
+
+bool
+glif_find_spike_time_method( const std::string& name, glif_spike_time_method& method )
+{
+  if ( name == "linear" )
+  {
+    method = glif_spike_time_linear;
+  }
+  else if ( name == "hermite" )
+  {
+    method = glif_spike_time_hermite;
+  }
+  else if ( name == "exact" )
+  {
+    method = glif_spike_time_exact;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+/* ----------------------------------------------------------------
+ * Explicit instantiations for the models of the module
+ * ---------------------------------------------------------------- */
+
+template class glif_kernel< glif_fixed_reset, glif_no_asc, glif_no_voltage_threshold, glif_current_input >;
+template class glif_kernel< glif_reset_rules, glif_no_asc, glif_no_voltage_threshold, glif_current_input >;
+template class glif_kernel< glif_fixed_reset, glif_asc, glif_no_voltage_threshold, glif_current_input >;
+template class glif_kernel< glif_reset_rules, glif_asc, glif_no_voltage_threshold, glif_current_input >;
+template class glif_kernel< glif_reset_rules, glif_asc, glif_voltage_threshold, glif_current_input >;
+template class glif_kernel< glif_fixed_reset, glif_no_asc, glif_no_voltage_threshold, glif_alpha_psc >;
+template class glif_kernel< glif_reset_rules, glif_no_asc, glif_no_voltage_threshold, glif_alpha_psc >;
+template class glif_kernel< glif_fixed_reset, glif_asc, glif_no_voltage_threshold, glif_alpha_psc >;
+template class glif_kernel< glif_reset_rules, glif_asc, glif_no_voltage_threshold, glif_alpha_psc >;
+template class glif_kernel< glif_reset_rules, glif_asc, glif_voltage_threshold, glif_alpha_psc >;
+
+} // namespace nest
@@ -0,0 +1,1261 @@
+#ifndef GLIF_KERNEL_H
+#define GLIF_KERNEL_H
+
+// C++ includes:
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "glif_active_receptors.h"
+#include "glif_receptor_classes.h"
+#include "glif_small_vector.h"
+#include "glif_v_dynamics.h"
+
+namespace nest
+{
+
+/*
+ * Feature policies of glif_kernel and glif_neuron, one for each mechanism of
+ * the GLIF models [1]. The code of a mechanism whose policy is not enabled is
+ * removed from the update at compile time.
+ */
+
+//! V_m is reset to V_reset after a spike (GLIF 1 and 3)
+struct glif_fixed_reset
+{
+  static const bool enabled = false;
+};
+
+//! Biologically defined reset rules of V_m and of the spike component of the
+//! threshold (GLIF 2, 4 and 5)
+struct glif_reset_rules
+{
+  static const bool enabled = true;
+};
+
+//! No after-spike currents
+struct glif_no_asc
+{
+  static const bool enabled = false;
+  typedef glif_empty_vector< double > vector_type;
+};
+
+//! After-spike currents (GLIF 3, 4 and 5)
+struct glif_asc
+{
+  static const bool enabled = true;
+  typedef glif_small_vector< double, 2 > vector_type;
+};
+
+//! Threshold without voltage component
+struct glif_no_voltage_threshold
+{
+  static const bool enabled = false;
+};
+
+//! Voltage dependent component of the threshold (GLIF 5)
+struct glif_voltage_threshold
+{
+  static const bool enabled = true;
+};
+
+//! Current input only, spike events are accepted on port 0 and ignored
+struct glif_current_input
+{
+  static const bool enabled = false;
+  typedef glif_empty_vector< double > vector_type;
+};
+
+//! Alpha-function shaped synaptic currents, one receptor port per tau_syn,
+//! with one state per class of ports of equal tau_syn
+struct glif_alpha_psc
+{
+  static const bool enabled = true;
+  typedef glif_small_vector< double, 4 > vector_type;
+};
+
+//! Propagator of the synaptic current y1 to V_m over a step h for a synaptic
+//! time constant tau_syn, membrane time constant tau in ms and capacitance C
+//! in pF, with the same numerical stability criterion as NEST's
+//! propagator_stability
+double glif_propagator_31( const double tau_syn, const double tau, const double C, const double h );
+
+//! Propagator of the synaptic current y2 to V_m, see glif_propagator_31
+double glif_propagator_32( const double tau_syn, const double tau, const double C, const double h );
+
+//! Number of Taylor terms per sub-step of glif_kernel::crossing_basis
+const size_t glif_crossing_basis_order = 20;
+
+//! Sets E to the exponential of the n x n matrix A t, both row-major, by
+//! scaling and squaring of its Taylor series; work is scratch of 2 n^2
+//! elements, which is resized only if smaller
+void glif_matrix_exponential( const std::vector< double >& A,
+  const size_t n,
+  const double t,
+  std::vector< double >& E,
+  std::vector< double >& work );
+
+//! Methods of locating the threshold crossing within a step, see
+//! glif_kernel::locate_crossing
+enum glif_spike_time_method
+{
+  glif_spike_time_linear,  //!< linear interpolation of V_m and the threshold
+  glif_spike_time_hermite, //!< cubic Hermite interpolation of V_m less the threshold
+  glif_spike_time_exact    //!< root finding on the solution within the step
+};
+
+//! Sets method to the method of the given spike_time_method parameter value,
+//! returns false for unknown names
+bool glif_find_spike_time_method( const std::string& name, glif_spike_time_method& method );
+
+/**
+ * Dynamics of the current based GLIF models [1] without dependence on NEST,
+ * for the mechanisms selected by the policies TReset, TASC, TThreshold and
+ * TSynapse. glif_neuron wraps it into a NEST node; other simulators and
+ * offline fitting use it directly through the batched step():
+ *
+ *   glif_lif_r_asc_a_psc_kernel::Neuron neurons[ n ];
+ *   glif_lif_r_asc_a_psc_kernel::Input inputs[ n ];
+ *   double spike_offsets[ n ];
+ *   for ( size_t i = 0; i < n; ++i )
+ *   {
+ *     glif_lif_r_asc_a_psc_kernel::calibrate( neurons[ i ], dt );
+ *   }
+ *   // per step: set inputs[ i ].I_ and inputs[ i ].spikes_, then
+ *   glif_lif_r_asc_a_psc_kernel::step( neurons, inputs, n, dt, spike_offsets );
+ *
+ * The members keep the names of glif_neuron, whose Parameters_, State_ and
+ * Variables_ derive from Parameters, State and Propagators.
+ *
+ * References:
+ *   [1] Teeter C, Iyer R, Menon V, Gouwens N, Feng D, Berg J, Szafer A,
+ *       Cain N, Zeng H, Hawrylycz M, Koch C, & Mihalas S (2018)
+ *       Generalized leaky integrate-and-fire models classify multiple neuron
+ *       types. Nature Communications 9:709.
+ */
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+class glif_kernel
+{
+public:
+  typedef typename TASC::vector_type ASCVector;
+  typedef typename TSynapse::vector_type ReceptorVector;
+
+  struct Parameters
+  {
+    double th_inf_; // infinity threshold in mV
+    double G_;      // membrane conductance in nS
+    double E_L_;    // resting potential in mV
+    double C_m_;    // capacitance in pF
+    double t_ref_;  // refractory time in ms
+
+    double V_reset_; // reset potential in mV, fixed reset only
+
+    double a_spike_;         // threshold additive constant following reset in mV
+    double b_spike_;         // spike induced threshold in 1/ms
+    double voltage_reset_a_; // voltage fraction following reset coefficient
+    double voltage_reset_b_; // voltage additive constant following reset in mV
+
+    double a_voltage_; // a 'leak-conductance' for the voltage-dependent component of the threshold in 1/ms
+    double b_voltage_; // inverse of which is the time constant of the voltage-dependent component of the threshold in 1/ms
+
+    std::vector< double > asc_init_; // initial values of ASCurrents_ in pA
+    std::vector< double > k_;        // predefined time scale in 1/ms
+    std::vector< double > asc_amps_; // in pA
+    std::vector< double > r_;        // coefficient
+
+    std::vector< double > tau_syn_; // synaptic port time constants in ms
+
+    std::string V_dynamics_method_; // voltage dynamic methods, see glif_v_dynamics_method
+    std::string spike_time_method_; // threshold crossing localisation, see glif_spike_time_method
+
+    double receptor_tol_; // synaptic current in pA within which a decayed receptor port is inactive
+
+    size_t n_receptors_() const; //!< Returns the size of tau_syn_
+
+    Parameters();
+  };
+
+  struct State
+  {
+    // fields used in every step come first, next to each other in memory
+    double V_m_;             // membrane potential in mV
+    double ASCurrents_sum_;  // in pA
+    double threshold_;       // voltage threshold in mV
+    double I_;               // external current in pA
+    double I_syn_;           // post synaptic current in pA
+    double t_ref_remaining_; // counter during refractory period, in ms
+    double last_spike_;      // threshold spike component in mV
+    double last_voltage_;    // threshold voltage component in mV
+
+    ASCVector ASCurrents_; // after-spike currents in pA
+    ReceptorVector y1_;    // synapse current evolution state 1 in pA, per receptor class
+    ReceptorVector y2_;    // synapse current evolution state 2 in pA, per receptor class
+
+    glif_active_receptors active_receptors_; // receptor classes with synaptic currents
+
+    State();
+  };
+
+  //! Per-step propagators for the step h_
+  struct Propagators
+  {
+    double h_;           // step in ms
+    double t_ref_total_; // total time of refractory period, in ms
+
+    glif_spike_time_method spike_time_method_; // threshold crossing localisation
+
+    double P_V_;             // decay of V_m towards its equilibrium per step, see glif_v_dynamics_method
+    double P30_;             // membrane current/voltage evolution parameter, see glif_v_dynamics_method
+    double P_leak_;          // decay of V_m without input per step, exp( -g h / C_m )
+    double P_th_;            // decay of the spike component of the threshold per step
+    double P_voltage_;       // decay of the voltage component of the threshold per step
+    ASCVector P_asc_;        // decay of the after-spike currents per step
+    ASCVector P_asc_reset_;  // after-spike current fraction kept at reset, r exp( -k t_ref )
+    ReceptorVector P11_;     // synaptic current evolution parameter, per receptor class
+    ReceptorVector P21_;     // synaptic current evolution parameter, per receptor class
+    ReceptorVector P22_;     // synaptic current evolution parameter, per receptor class
+    ReceptorVector P31_;     // synaptic/membrane current evolution parameter, per receptor class
+    ReceptorVector P32_;     // synaptic/membrane current evolution parameter, per receptor class
+
+    std::vector< size_t > receptor_class_; // class of each receptor port, see glif_receptor_classes
+    std::vector< size_t > class_port_;     // first receptor port of each class
+    ReceptorVector tau_syn_;               // synaptic time constant of each class in ms
+
+    /** Propagator of the linear state for full state voltage dynamics
+              methods, row-major, empty otherwise. The state is
+              ( V_m - E_L, ASCurrents_, last_voltage_, y1_, y2_, I_ ) of
+              size n_state_, which step() advances by one mat-vec product.
+    */
+    std::vector< double > P_state_;
+    size_t n_state_;
+
+    //! Generator of the linear state in 1/ms, row-major, whose exponential
+    //! over h_ is P_state_; set up by calibrate()
+    std::vector< double > A_state_;
+    std::vector< double > exp_work_; // scratch of glif_matrix_exponential
+
+    //! Scratch of propagate_state(), sized by calibrate() so that stepping
+    //! does not allocate
+    mutable std::vector< double > x_state_;
+    mutable std::vector< double > x_state_new_;
+
+    //! Taylor coefficients of V_m less the threshold on the sub-steps of
+    //! crossing_substep_ in ms, see crossing_basis(), and their scratch
+    mutable std::vector< double > crossing_basis_;
+    mutable double crossing_substep_;
+    mutable std::vector< double > crossing_work_;
+
+    /** Amplitude of the synaptic current.
+              This value is chosen such that a post-synaptic current with
+              weight one has an amplitude of 1 pA.
+    */
+    ReceptorVector PSCInitialValues_;
+
+    Propagators();
+  };
+
+  //! One neuron of the batched step()
+  struct Neuron
+  {
+    Parameters p_;
+    Propagators v_;
+    State s_;
+  };
+
+  //! Input of one neuron in one step of the batched step()
+  struct Input
+  {
+    double I_; //!< current in pA during the step
+
+    //! summed synaptic weights per receptor port, arriving at the end of the
+    //! step; empty for no spikes
+    std::vector< double > spikes_;
+
+    Input();
+  };
+
+  //! Computes the propagators of the step h in ms for the receptor classes
+  //! and linear state set up by calibrate(), which it does not change
+  static void propagators( const Parameters&, const double h, Propagators& );
+
+  //! Sorts the receptor ports into classes, computes the propagators of the
+  //! step h in ms and prepares the state for a simulation: not refractory,
+  //! threshold components at zero. Returns true if the receptor ports were
+  //! sorted into other classes than before, whose synaptic state is then
+  //! reset to zero
+  static bool calibrate( const Parameters&, const double h, Propagators&, State& );
+
+  static void calibrate( Neuron&, const double h );
+
+  /**
+   * Advances the state by one step of v.h_ from V_m v_old and threshold
+   * th_old, with the after-spike currents and the voltage component of the
+   * threshold only if enabled here. The external current s.I_ is held during
+   * the step; the input arriving at its end is added by the caller. Returns
+   * true if the neuron spiked, with the time of the threshold crossing
+   * before the end of the step in spike_offset.
+   */
+  template < bool ASC, bool VoltageThreshold >
+  static bool step( const Parameters&, const Propagators&, State&, const double, const double, double& spike_offset );
+
+  /**
+   * Locates the threshold crossing of the step from the state s_start, which
+   * step() advanced to s and reported as spiked or not, with the spike time
+   * method of v instead of the linear interpolation of step(). A crossing
+   * that step() missed because V_m fell below the threshold again before
+   * the end of the step is detected at the maximum of the cubic Hermite
+   * interpolation of V_m less the threshold; s is then made refractory.
+   * Returns true if the neuron spiked, with the time of the threshold
+   * crossing before the end of the step in spike_offset.
+   */
+  template < bool ASC, bool VoltageThreshold >
+  static bool locate_crossing( const Parameters&,
+    const Propagators&,
+    const State& s_start,
+    State& s,
+    const bool spiked,
+    double& spike_offset );
+
+  //! Prepares distance_to_threshold() from the state s, which is not
+  //! refractory, for times up to t in ms. For full state methods, V_m less
+  //! the threshold is expanded into Taylor polynomials of sub-steps short
+  //! enough for the series to converge, so that it is evaluated without
+  //! propagators; other methods need no preparation
+  static void crossing_basis( const Parameters&, const Propagators&, const State& s, const double t );
+
+  //! V_m less the threshold after t in ms from the state s, which is not
+  //! refractory, on the solution of the voltage dynamics method over t;
+  //! requires crossing_basis() of s for a time of at least t
+  template < bool ASC, bool VoltageThreshold >
+  static double distance_to_threshold( const Parameters&, const Propagators&, const State& s, const double t );
+
+  //! Time in ms at which V_m crosses the threshold, starting below it in the
+  //! state s and ending after t in ms at the distance f_t > 0 above it;
+  //! requires crossing_basis() of s for a time of at least t
+  template < bool ASC, bool VoltageThreshold >
+  static double find_crossing( const Parameters&,
+    const Propagators&,
+    const State& s,
+    const double t,
+    const double f_t );
+
+  //! Time derivative of V_m less the threshold in mV/ms in the state s, with
+  //! the sum of the after-spike currents asc_sum in pA
+  template < bool VoltageThreshold >
+  static double distance_slope( const Parameters&, const State& s, const double asc_sum );
+
+  //! Advances V_m, the after-spike currents, the voltage component of the
+  //! threshold and the synaptic currents of the state s by one step of v.h_
+  //! from V_m v_old, exactly by the propagator v.P_state_
+  static void propagate_state( const Parameters&, const Propagators&, State& s, const double v_old );
+
+  //! Adds the summed weight of the spikes arriving at the end of the step at
+  //! the ports of receptor class c to its synaptic current and makes the
+  //! class active
+  static void add_spikes( const Propagators&, State& s, const size_t c, const double weight );
+
+  //! Whether the receptor class c stays active; otherwise its synaptic
+  //! current has decayed to within p.receptor_tol_ of zero and is set to zero
+  static bool receptor_active( const Parameters&, State& s, const size_t c );
+
+  /**
+   * Advances the n neurons by one step of dt in ms, driven by their inputs.
+   * The propagators are recomputed for neurons calibrated for another step.
+   * Returns the number of neurons that spiked; spike_offsets[ i ] is the
+   * time of the threshold crossing of neuron i before the end of the step in
+   * ms, or -1 if it did not spike.
+   */
+  static size_t step( Neuron neurons[], const Input inputs[], const size_t n, const double dt, double spike_offsets[] );
+};
+
+/*
+ * The kernels of the models of the module, named after them
+ */
+typedef glif_kernel< glif_fixed_reset, glif_no_asc, glif_no_voltage_threshold, glif_current_input > glif_lif_kernel;
+typedef glif_kernel< glif_reset_rules, glif_no_asc, glif_no_voltage_threshold, glif_current_input >
+  glif_lif_r_kernel;
+typedef glif_kernel< glif_fixed_reset, glif_asc, glif_no_voltage_threshold, glif_current_input > glif_lif_asc_kernel;
+typedef glif_kernel< glif_reset_rules, glif_asc, glif_no_voltage_threshold, glif_current_input >
+  glif_lif_r_asc_kernel;
+typedef glif_kernel< glif_reset_rules, glif_asc, glif_voltage_threshold, glif_current_input >
+  glif_lif_r_asc_a_kernel;
+typedef glif_kernel< glif_fixed_reset, glif_no_asc, glif_no_voltage_threshold, glif_alpha_psc > glif_lif_psc_kernel;
+typedef glif_kernel< glif_reset_rules, glif_no_asc, glif_no_voltage_threshold, glif_alpha_psc >
+  glif_lif_r_psc_kernel;
+typedef glif_kernel< glif_fixed_reset, glif_asc, glif_no_voltage_threshold, glif_alpha_psc > glif_lif_asc_psc_kernel;
+typedef glif_kernel< glif_reset_rules, glif_asc, glif_no_voltage_threshold, glif_alpha_psc >
+  glif_lif_r_asc_psc_kernel;
+typedef glif_kernel< glif_reset_rules, glif_asc, glif_voltage_threshold, glif_alpha_psc >
+  glif_lif_r_asc_a_psc_kernel;
+
+/* ----------------------------------------------------------------
+ * Default constructors defining default parameters and state
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::Parameters::Parameters()
+  : th_inf_( 26.5 )          // in mV
+  , G_( 4.6951 )             // in nS
+  , E_L_( -77.4 )            // in mV
+  , C_m_( 99.182 )           // in pF
+  , t_ref_( 0.5 )            // in ms
+  , V_reset_( -77.4 )        // in mV
+  , a_spike_( 0.0 )          // in mV
+  , b_spike_( 0.0 )          // in 1/ms
+  , voltage_reset_a_( 0.0 )  // coefficient
+  , voltage_reset_b_( 0.0 )  // in mV
+  , a_voltage_( 0.0 )        // in 1/ms
+  , b_voltage_( 0.0 )        // in 1/ms
+  , asc_init_( TASC::enabled ? 2 : 0, 0.0 ) // in pA
+  , k_( TASC::enabled ? 2 : 0, 0.0 )        // in 1/ms
+  , asc_amps_( TASC::enabled ? 2 : 0, 0.0 ) // in pA
+  , r_( TASC::enabled ? 2 : 0, 1.0 )        // coefficient
+  , tau_syn_( TSynapse::enabled ? 1 : 0, 2.0 ) // in ms
+  , V_dynamics_method_( "linear_forward_euler" )
+  , spike_time_method_( "linear" )
+  , receptor_tol_( std::numeric_limits< double >::min() ) // in pA
+{
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline size_t
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::Parameters::n_receptors_() const
+{
+  return tau_syn_.size();
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::State::State()
+  : V_m_( -77.4 )            // in mV
+  , ASCurrents_sum_( 0.0 )   // in pA
+  , threshold_( 26.5 )       // in mV
+  , I_( 0.0 )                // in pA
+  , I_syn_( 0.0 )            // in pA
+  , t_ref_remaining_( 0.0 )  // in ms
+  , last_spike_( 0.0 )       // in mV
+  , last_voltage_( 0.0 )     // in mV
+  , ASCurrents_( TASC::enabled ? 2 : 0, 0.0 ) // in pA
+{
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::Propagators::Propagators()
+  : h_( 0.0 )
+  , t_ref_total_( 0.0 )
+  , spike_time_method_( glif_spike_time_linear )
+  , P_V_( 1.0 )
+  , P30_( 0.0 )
+  , P_leak_( 1.0 )
+  , P_th_( 1.0 )
+  , P_voltage_( 1.0 )
+  , n_state_( 0 )
+  , crossing_substep_( 0.0 )
+{
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::Input::Input()
+  : I_( 0.0 )
+{
+}
+
+/* ----------------------------------------------------------------
+ * Propagators
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::propagators( const Parameters& p, const double h, Propagators& v )
+{
+  v.h_ = h;
+  v.t_ref_total_ = p.t_ref_;
+
+  const size_t n_classes = v.tau_syn_.size();
+
+  // the voltage dynamics method only determines the propagators of V_m, so
+  // that step() does not depend on it; unknown names are rejected by the
+  // parameters of the wrappers
+  const glif_v_dynamics_method* method = glif_find_v_dynamics_method( p.V_dynamics_method_ );
+  assert( method );
+  method->propagators( h, p.G_, p.C_m_, v.P_V_, v.P30_ );
+
+  // the propagator of the linear state over h, exp( A h )
+  if ( v.n_state_ > 0 )
+  {
+    glif_matrix_exponential( v.A_state_, v.n_state_, h, v.P_state_, v.exp_work_ );
+  }
+
+  v.spike_time_method_ = glif_spike_time_linear;
+  glif_find_spike_time_method( p.spike_time_method_, v.spike_time_method_ );
+
+  // per-step propagators, so that step() only multiplies and adds
+  v.P_leak_ = std::exp( -p.G_ * h / p.C_m_ );
+  v.P_th_ = std::exp( -p.b_spike_ * h );
+  v.P_voltage_ = std::exp( -p.b_voltage_ * h );
+
+  v.P_asc_.resize( p.k_.size() );
+  v.P_asc_reset_.resize( p.k_.size() );
+  for ( std::size_t a = 0; a < p.k_.size(); ++a )
+  {
+    v.P_asc_[ a ] = std::exp( -p.k_[ a ] * h );
+    v.P_asc_reset_[ a ] = p.r_[ a ] * std::exp( -p.k_[ a ] * v.t_ref_total_ );
+  }
+
+  // post synapse currents
+  v.P11_.resize( n_classes );
+  v.P21_.resize( n_classes );
+  v.P22_.resize( n_classes );
+  v.P31_.resize( n_classes );
+  v.P32_.resize( n_classes );
+  v.PSCInitialValues_.resize( n_classes );
+
+  const double Tau = p.C_m_ / p.G_; // in ms
+  for ( size_t i = 0; i < n_classes; i++ )
+  {
+    const double tau_syn = v.tau_syn_[ i ];
+
+    // these P are independent
+    v.P11_[ i ] = v.P22_[ i ] = std::exp( -h / tau_syn );
+
+    v.P21_[ i ] = h * v.P11_[ i ];
+
+    // these are determined according to a numeric stability criterion
+    // input time parameter shall be in ms, capacity in pF
+    v.P31_[ i ] = glif_propagator_31( tau_syn, Tau, p.C_m_, h );
+    v.P32_[ i ] = glif_propagator_32( tau_syn, Tau, p.C_m_, h );
+
+    v.PSCInitialValues_[ i ] = 1.0 * std::exp( 1.0 ) / tau_syn;
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+bool
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::calibrate( const Parameters& p,
+  const double h,
+  Propagators& v,
+  State& s )
+{
+  s.t_ref_remaining_ = 0.0;
+  s.last_spike_ = 0.0;
+  s.last_voltage_ = 0.0;
+
+  // receptor ports of equal tau_syn_ share the synaptic state of a class
+  const std::vector< size_t > receptor_class = v.receptor_class_;
+  glif_receptor_classes( p.tau_syn_, std::vector< double >(), v.receptor_class_, v.class_port_ );
+  const size_t n_classes = v.class_port_.size();
+  v.tau_syn_.resize( n_classes );
+  for ( size_t i = 0; i < n_classes; i++ )
+  {
+    v.tau_syn_[ i ] = p.tau_syn_[ v.class_port_[ i ] ];
+  }
+
+  // the linear state ( V_m - E_L, ASCurrents_, last_voltage_, y1_, y2_, I_ )
+  // obeys dx/dt = A x, whose propagator over h is exp( A h )
+  v.A_state_.clear();
+  v.n_state_ = 0;
+  const glif_v_dynamics_method* method = glif_find_v_dynamics_method( p.V_dynamics_method_ );
+  assert( method );
+  if ( method->full_state )
+  {
+    const size_t n_asc = p.k_.size();
+    const size_t i_th = 1 + n_asc;
+    const size_t i_y1 = i_th + 1;
+    const size_t i_y2 = i_y1 + n_classes;
+    const size_t i_I = i_y2 + n_classes;
+    const size_t n = i_I + 1;
+
+    std::vector< double >& A = v.A_state_;
+    A.assign( n * n, 0.0 );
+    A[ 0 ] = -p.G_ / p.C_m_;
+    A[ i_I ] = 1.0 / p.C_m_;
+    for ( size_t a = 0; a < n_asc; ++a )
+    {
+      A[ 1 + a ] = 1.0 / p.C_m_;
+      A[ ( 1 + a ) * n + 1 + a ] = -p.k_[ a ];
+    }
+    if ( TThreshold::enabled )
+    {
+      A[ i_th * n ] = p.a_voltage_;
+      A[ i_th * n + i_th ] = -p.b_voltage_;
+    }
+    for ( size_t i = 0; i < n_classes; ++i )
+    {
+      A[ i_y2 + i ] = 1.0 / p.C_m_;
+      A[ ( i_y1 + i ) * n + i_y1 + i ] = -1.0 / v.tau_syn_[ i ];
+      A[ ( i_y2 + i ) * n + i_y1 + i ] = 1.0;
+      A[ ( i_y2 + i ) * n + i_y2 + i ] = -1.0 / v.tau_syn_[ i ];
+    }
+
+    v.n_state_ = n;
+    v.x_state_.resize( n );
+    v.x_state_new_.resize( n - 1 );
+    v.crossing_work_.resize( 4 * n );
+  }
+
+  propagators( p, h, v );
+
+  // the synaptic state of a class holds the sum over its ports, which cannot
+  // be split among other classes after tau_syn_ changed
+  const bool new_classes = v.receptor_class_ != receptor_class;
+  if ( new_classes )
+  {
+    s.y1_.clear();
+    s.y2_.clear();
+  }
+  s.y1_.resize( v.class_port_.size() );
+  s.y2_.resize( v.class_port_.size() );
+
+  s.active_receptors_.clear();
+  for ( size_t i = 0; i < s.y1_.size(); i++ )
+  {
+    if ( s.y1_[ i ] != 0.0 or s.y2_[ i ] != 0.0 )
+    {
+      s.active_receptors_.insert( i );
+    }
+  }
+  return new_classes;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::calibrate( Neuron& n, const double h )
+{
+  calibrate( n.p_, h, n.v_, n.s_ );
+}
+
+/* ----------------------------------------------------------------
+ * Update functions
+ * ---------------------------------------------------------------- */
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+template < bool ASC, bool VoltageThreshold >
+inline bool
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::step( const Parameters& p,
+  const Propagators& v,
+  State& s,
+  const double v_old,
+  const double th_old,
+  double& spike_offset )
+{
+  bool spiked = false;
+
+  if ( TReset::enabled )
+  {
+    // update threshold via exact solution of dynamics of spike component of threshold
+    s.last_spike_ *= v.P_th_;
+    if ( not VoltageThreshold )
+    {
+      s.threshold_ = s.last_spike_ + p.th_inf_;
+    }
+  }
+
+  const bool refractory = s.t_ref_remaining_ > 0.0;
+  if ( refractory )
+  {
+    // While neuron is in refractory period count-down in time steps (since dt
+    // may change while in refractory) while holding the voltage at last peak.
+    s.t_ref_remaining_ -= v.h_;
+    if ( s.t_ref_remaining_ <= 0.0 )
+    {
+      // Neuron has left refractory period, reset voltage and after-spike current
+
+      // Reset ASC_currents
+      if ( ASC )
+      {
+        for ( std::size_t a = 0; a < s.ASCurrents_.size(); ++a )
+        {
+          s.ASCurrents_[ a ] = p.asc_amps_[ a ] + s.ASCurrents_[ a ] * v.P_asc_reset_[ a ];
+        }
+      }
+
+      if ( TReset::enabled )
+      {
+        // Reset voltage
+        s.V_m_ = p.E_L_ + p.voltage_reset_a_ * ( s.V_m_ - p.E_L_ ) + p.voltage_reset_b_;
+
+        // reset spike component of threshold
+        s.last_spike_ = s.last_spike_ + p.a_spike_;
+
+        // reset the global threshold (voltage component of threshold: stay the same)
+        s.threshold_ = s.last_spike_ + s.last_voltage_ + p.th_inf_;
+
+        // Check if bad reset
+        // TODO: Better way to handle?
+        if ( s.V_m_ > s.threshold_ )
+        {
+          printf( "Simulation Terminated: Voltage (%f) reset above threshold (%f)!!\n", s.V_m_, s.threshold_ );
+        }
+        assert( s.V_m_ <= s.threshold_ );
+      }
+      else
+      {
+        // Reset voltage
+        s.V_m_ = p.V_reset_;
+      }
+    }
+    else
+    {
+      s.V_m_ = v_old;
+    }
+  }
+  else
+  {
+    if ( v.n_state_ > 0 )
+    {
+      // Integrate voltage, currents and threshold together
+      propagate_state( p, v, s, v_old );
+    }
+    else
+    {
+      // Integrate voltage and currents
+
+      // Calculate new ASCurrents value using exponential methods
+      if ( ASC )
+      {
+        s.ASCurrents_sum_ = 0.0;
+        for ( std::size_t a = 0; a < s.ASCurrents_.size(); ++a )
+        {
+          s.ASCurrents_sum_ += s.ASCurrents_[ a ];
+          s.ASCurrents_[ a ] = s.ASCurrents_[ a ] * v.P_asc_[ a ];
+        }
+      }
+
+      // voltage dynamics of membranes, the same for all methods
+      s.V_m_ = v_old * v.P_V_ + ( s.I_ + s.ASCurrents_sum_ + p.G_ * p.E_L_ ) * v.P30_;
+
+      if ( TSynapse::enabled )
+      {
+        // add synapse component for voltage dynamics of the active ports
+        s.I_syn_ = 0.0;
+        for ( size_t k = 0; k < s.active_receptors_.size(); k++ )
+        {
+          const size_t i = s.active_receptors_[ k ];
+          s.V_m_ += v.P31_[ i ] * s.y1_[ i ] + v.P32_[ i ] * s.y2_[ i ];
+          s.I_syn_ += s.y2_[ i ];
+        }
+      }
+
+      if ( VoltageThreshold )
+      {
+        // Calculate exact voltage component of the threshold
+        const double beta = ( s.I_ + s.ASCurrents_sum_ + p.G_ * p.E_L_ ) / p.G_;
+        const double phi = p.a_voltage_ / ( p.b_voltage_ - p.G_ / p.C_m_ );
+        const double voltage_component = phi * ( v_old - beta ) * v.P_leak_
+          + v.P_voltage_ * ( s.last_voltage_ - phi * ( v_old - beta ) - ( p.a_voltage_ / p.b_voltage_ ) * ( beta - p.E_L_ ) )
+          + ( p.a_voltage_ / p.b_voltage_ ) * ( beta - p.E_L_ );
+
+        s.threshold_ = s.last_spike_ + voltage_component + p.th_inf_;
+        s.last_voltage_ = voltage_component;
+      }
+    }
+
+    // Check if there is an action potential
+    if ( s.V_m_ > s.threshold_ )
+    {
+      // Marks that the neuron is in a refractory period
+      s.t_ref_remaining_ = v.t_ref_total_;
+
+      // Find the exact time during this step that the neuron crossed the threshold
+      spike_offset = ( 1 - ( v_old - th_old ) / ( ( s.threshold_ - th_old ) - ( s.V_m_ - v_old ) ) ) * v.h_;
+      spiked = true;
+    }
+  }
+
+  // alpha shape PSCs of the active ports, unless propagated with the state
+  if ( TSynapse::enabled )
+  {
+    const bool alpha = v.n_state_ == 0 or refractory;
+    size_t n_active = 0;
+    for ( size_t k = 0; k < s.active_receptors_.size(); k++ )
+    {
+      const size_t i = s.active_receptors_[ k ];
+      if ( alpha )
+      {
+        s.y2_[ i ] = v.P21_[ i ] * s.y1_[ i ] + v.P22_[ i ] * s.y2_[ i ];
+        s.y1_[ i ] *= v.P11_[ i ];
+      }
+      if ( receptor_active( p, s, i ) )
+      {
+        s.active_receptors_[ n_active++ ] = i;
+      }
+    }
+    s.active_receptors_.truncate( n_active );
+  }
+
+  return spiked;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+template < bool ASC, bool VoltageThreshold >
+bool
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::locate_crossing( const Parameters& p,
+  const Propagators& v,
+  const State& s_start,
+  State& s,
+  const bool spiked,
+  double& spike_offset )
+{
+  // V_m less the threshold at both ends of the step; a neuron that was
+  // refractory or above the threshold at the start keeps the outcome of step()
+  const double f_0 = s_start.V_m_ - s_start.threshold_;
+  const double f_1 = s.V_m_ - s.threshold_;
+  if ( v.spike_time_method_ == glif_spike_time_linear or s_start.t_ref_remaining_ > 0.0 or f_0 >= 0.0 )
+  {
+    return spiked;
+  }
+
+  // cubic Hermite interpolation a_3 u^3 + a_2 u^2 + a_1 u + a_0 over the step
+  // scaled to u in [0, 1], from the values and slopes at both ends; the
+  // after-spike currents are held at their sum during the step
+  const double m_0 = v.h_ * distance_slope< VoltageThreshold >( p, s_start, s.ASCurrents_sum_ );
+  const double m_1 = v.h_ * distance_slope< VoltageThreshold >( p, s, s.ASCurrents_sum_ );
+  const double a_3 = 2.0 * f_0 + m_0 - 2.0 * f_1 + m_1;
+  const double a_2 = -3.0 * f_0 - 2.0 * m_0 + 3.0 * f_1 - m_1;
+  const double a_1 = m_0;
+
+  // the maximum of the interpolation within the step, the root of its slope
+  // 3 a_3 u^2 + 2 a_2 u + a_1 at which the slope decreases
+  double u_max = -1.0;
+  if ( std::abs( a_3 ) < 1e-12 * ( std::abs( a_2 ) + std::abs( a_1 ) ) )
+  {
+    if ( a_2 < 0.0 )
+    {
+      u_max = -a_1 / ( 2.0 * a_2 );
+    }
+  }
+  else
+  {
+    const double discriminant = a_2 * a_2 - 3.0 * a_3 * a_1;
+    if ( discriminant > 0.0 )
+    {
+      u_max = ( -a_2 - std::sqrt( discriminant ) ) / ( 3.0 * a_3 );
+    }
+  }
+
+  // the first crossing lies in [0, u_b]: up to the maximum if V_m exceeds
+  // the threshold there, else the whole step if V_m ends above it
+  double u_b = 1.0;
+  double f_b = f_1;
+  bool basis = false;
+  if ( u_max > 0.0 and u_max < 1.0 )
+  {
+    if ( v.spike_time_method_ == glif_spike_time_exact )
+    {
+      crossing_basis( p, v, s_start, v.h_ );
+      basis = true;
+    }
+    const double f_max = v.spike_time_method_ == glif_spike_time_exact
+      ? distance_to_threshold< ASC, VoltageThreshold >( p, v, s_start, u_max * v.h_ )
+      : ( ( a_3 * u_max + a_2 ) * u_max + a_1 ) * u_max + f_0;
+    if ( f_max > 0.0 )
+    {
+      u_b = u_max;
+      f_b = f_max;
+    }
+  }
+  if ( f_b <= 0.0 )
+  {
+    return false;
+  }
+
+  // a missed crossing: the neuron is refractory from the end of the step on,
+  // as after a crossing detected by step()
+  if ( not spiked )
+  {
+    s.t_ref_remaining_ = v.t_ref_total_;
+  }
+
+  double t_cross;
+  if ( v.spike_time_method_ == glif_spike_time_exact )
+  {
+    // the basis is built once per step, only for steps with a crossing
+    if ( not basis )
+    {
+      crossing_basis( p, v, s_start, v.h_ );
+    }
+    t_cross = find_crossing< ASC, VoltageThreshold >( p, v, s_start, u_b * v.h_, f_b );
+  }
+  else
+  {
+    // bisection on the interpolation, which costs no propagators
+    double u_a = 0.0;
+    for ( int iter = 0; iter < 50; ++iter )
+    {
+      const double u_c = 0.5 * ( u_a + u_b );
+      if ( ( ( a_3 * u_c + a_2 ) * u_c + a_1 ) * u_c + f_0 > 0.0 )
+      {
+        u_b = u_c;
+      }
+      else
+      {
+        u_a = u_c;
+      }
+    }
+    t_cross = u_b * v.h_;
+  }
+
+  spike_offset = v.h_ - t_cross;
+  return true;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+void
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::crossing_basis( const Parameters& p,
+  const Propagators& v,
+  const State& s,
+  const double t )
+{
+  if ( v.n_state_ == 0 )
+  {
+    return;
+  }
+  const size_t n = v.n_state_;
+  const std::vector< double >& A = v.A_state_;
+
+  // sub-steps on which A times their length has a norm of at most one, so
+  // that glif_crossing_basis_order terms of the series reach round-off
+  double norm = 0.0;
+  for ( size_t r = 0; r < n; ++r )
+  {
+    double row = 0.0;
+    for ( size_t c = 0; c < n; ++c )
+    {
+      row += std::abs( A[ r * n + c ] );
+    }
+    norm = std::max( norm, row );
+  }
+  const size_t n_substeps = std::max( static_cast< size_t >( std::ceil( norm * t ) ), static_cast< size_t >( 1 ) );
+  const double dt = t / n_substeps;
+  v.crossing_substep_ = dt;
+  v.crossing_basis_.resize( n_substeps * glif_crossing_basis_order );
+
+  // the state in the order of A_state_, see calibrate()
+  double* x = &v.crossing_work_[ 0 ];
+  double* x_next = &v.crossing_work_[ n ];
+  double* z = &v.crossing_work_[ 2 * n ];
+  double* z_next = &v.crossing_work_[ 3 * n ];
+  size_t k = 0;
+  x[ k++ ] = s.V_m_ - p.E_L_;
+  for ( std::size_t a = 0; a < s.ASCurrents_.size(); ++a )
+  {
+    x[ k++ ] = s.ASCurrents_[ a ];
+  }
+  const size_t i_th = k;
+  x[ k++ ] = s.last_voltage_;
+  for ( size_t i = 0; i < s.y1_.size(); i++ )
+  {
+    x[ k++ ] = s.y1_[ i ];
+  }
+  for ( size_t i = 0; i < s.y2_.size(); i++ )
+  {
+    x[ k++ ] = s.y2_[ i ];
+  }
+  x[ k ] = s.I_;
+
+  // V_m - E_L less the voltage component of the threshold at u within
+  // sub-step j is sum_k w_jk u^k with w_jk = c A^k x_j / k!, and
+  // x_j+1 = sum_k A^k x_j / k! dt^k
+  for ( size_t j = 0; j < n_substeps; ++j )
+  {
+    double* w = &v.crossing_basis_[ j * glif_crossing_basis_order ];
+    std::copy( x, x + n, z );
+    std::copy( x, x + n, x_next );
+    double dt_k = 1.0;
+    for ( size_t order = 0; order < glif_crossing_basis_order; ++order )
+    {
+      if ( order > 0 )
+      {
+        for ( size_t r = 0; r < n; ++r )
+        {
+          const double* A_r = &A[ r * n ];
+          double z_r = 0.0;
+          for ( size_t c = 0; c < n; ++c )
+          {
+            z_r += A_r[ c ] * z[ c ];
+          }
+          z_next[ r ] = z_r / order;
+        }
+        std::swap( z, z_next );
+        dt_k *= dt;
+        for ( size_t r = 0; r < n; ++r )
+        {
+          x_next[ r ] += z[ r ] * dt_k;
+        }
+      }
+      w[ order ] = TThreshold::enabled ? z[ 0 ] - z[ i_th ] : z[ 0 ];
+    }
+    std::swap( x, x_next );
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+template < bool ASC, bool VoltageThreshold >
+double
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::distance_to_threshold( const Parameters& p,
+  const Propagators& v,
+  const State& s,
+  const double t )
+{
+  if ( v.n_state_ > 0 )
+  {
+    // the Taylor polynomial of the sub-step of t, see crossing_basis()
+    const size_t n_substeps = v.crossing_basis_.size() / glif_crossing_basis_order;
+    const size_t j = std::min( static_cast< size_t >( t / v.crossing_substep_ ), n_substeps - 1 );
+    const double u = t - j * v.crossing_substep_;
+    const double* w = &v.crossing_basis_[ j * glif_crossing_basis_order ];
+    double distance = 0.0;
+    for ( size_t order = glif_crossing_basis_order; order > 0; --order )
+    {
+      distance = distance * u + w[ order - 1 ];
+    }
+
+    // the spike component of the threshold is not part of the linear state
+    double threshold = s.threshold_;
+    if ( TReset::enabled or TThreshold::enabled )
+    {
+      const double last_spike = TReset::enabled ? s.last_spike_ * std::exp( -p.b_spike_ * t ) : s.last_spike_;
+      threshold = last_spike + p.th_inf_;
+    }
+    return distance + p.E_L_ - threshold;
+  }
+
+  // propagators over t for the receptor classes of v
+  Propagators v_t;
+  v_t.tau_syn_ = v.tau_syn_;
+  propagators( p, t, v_t );
+
+  State s_t = s;
+  double spike_offset;
+  step< ASC, VoltageThreshold >( p, v_t, s_t, s_t.V_m_, s_t.threshold_, spike_offset );
+  return s_t.V_m_ - s_t.threshold_;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+template < bool ASC, bool VoltageThreshold >
+double
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::find_crossing( const Parameters& p,
+  const Propagators& v,
+  const State& s,
+  const double t,
+  const double f_t )
+{
+  // Illinois variant of regula falsi on V_m less the threshold, which is
+  // negative at the start and positive at t
+  double t_a = 0.0;
+  double f_a = s.V_m_ - s.threshold_;
+  double t_b = t;
+  double f_b = f_t;
+  if ( f_a >= 0.0 )
+  {
+    return 0.0;
+  }
+
+  const double tol = 1e-12 * t; // in ms
+  int side = 0;
+  for ( int iter = 0; iter < 100 and t_b - t_a > tol; ++iter )
+  {
+    const double t_c = ( t_a * f_b - t_b * f_a ) / ( f_b - f_a );
+    const double f_c = distance_to_threshold< ASC, VoltageThreshold >( p, v, s, t_c );
+    if ( f_c > 0.0 )
+    {
+      t_b = t_c;
+      f_b = f_c;
+      if ( side == -1 )
+      {
+        f_a /= 2.0;
+      }
+      side = -1;
+    }
+    else if ( f_c < 0.0 )
+    {
+      t_a = t_c;
+      f_a = f_c;
+      if ( side == 1 )
+      {
+        f_b /= 2.0;
+      }
+      side = 1;
+    }
+    else
+    {
+      return t_c;
+    }
+  }
+  return t_b;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+template < bool VoltageThreshold >
+inline double
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::distance_slope( const Parameters& p,
+  const State& s,
+  const double asc_sum )
+{
+  double I_syn = 0.0;
+  for ( size_t i = 0; i < s.y2_.size(); i++ )
+  {
+    I_syn += s.y2_[ i ];
+  }
+  double slope = ( s.I_ + asc_sum + I_syn - p.G_ * ( s.V_m_ - p.E_L_ ) ) / p.C_m_;
+
+  // the threshold components decay, the voltage component is driven by V_m
+  if ( TReset::enabled )
+  {
+    slope += p.b_spike_ * s.last_spike_;
+  }
+  if ( VoltageThreshold )
+  {
+    slope -= p.a_voltage_ * ( s.V_m_ - p.E_L_ ) - p.b_voltage_ * s.last_voltage_;
+  }
+  return slope;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline void
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::propagate_state( const Parameters& p,
+  const Propagators& v,
+  State& s,
+  const double v_old )
+{
+  // gather the state in the order of P_state_, see propagators()
+  const size_t n = v.n_state_;
+  std::vector< double >& x = v.x_state_;
+  size_t k = 0;
+  x[ k++ ] = v_old - p.E_L_;
+  s.ASCurrents_sum_ = 0.0;
+  for ( std::size_t a = 0; a < s.ASCurrents_.size(); ++a )
+  {
+    s.ASCurrents_sum_ += s.ASCurrents_[ a ];
+    x[ k++ ] = s.ASCurrents_[ a ];
+  }
+  x[ k++ ] = s.last_voltage_;
+  s.I_syn_ = 0.0;
+  for ( size_t i = 0; i < s.y1_.size(); i++ )
+  {
+    x[ k++ ] = s.y1_[ i ];
+  }
+  for ( size_t i = 0; i < s.y2_.size(); i++ )
+  {
+    s.I_syn_ += s.y2_[ i ];
+    x[ k++ ] = s.y2_[ i ];
+  }
+  x[ k ] = s.I_;
+
+  // one row of P_state_ per state variable but the constant input
+  std::vector< double >& x_new = v.x_state_new_;
+  for ( size_t r = 0; r < n - 1; ++r )
+  {
+    const double* P_r = &v.P_state_[ r * n ];
+    double x_r = 0.0;
+    for ( size_t c = 0; c < n; ++c )
+    {
+      x_r += P_r[ c ] * x[ c ];
+    }
+    x_new[ r ] = x_r;
+  }
+
+  k = 0;
+  s.V_m_ = x_new[ k++ ] + p.E_L_;
+  for ( std::size_t a = 0; a < s.ASCurrents_.size(); ++a )
+  {
+    s.ASCurrents_[ a ] = x_new[ k++ ];
+  }
+  s.last_voltage_ = x_new[ k++ ];
+  for ( size_t i = 0; i < s.y1_.size(); i++ )
+  {
+    s.y1_[ i ] = x_new[ k++ ];
+  }
+  for ( size_t i = 0; i < s.y2_.size(); i++ )
+  {
+    s.y2_[ i ] = x_new[ k++ ];
+  }
+
+  if ( TThreshold::enabled )
+  {
+    s.threshold_ = s.last_spike_ + s.last_voltage_ + p.th_inf_;
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline void
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::add_spikes( const Propagators& v,
+  State& s,
+  const size_t c,
+  const double weight )
+{
+  if ( weight != 0.0 )
+  {
+    s.y1_[ c ] += v.PSCInitialValues_[ c ] * weight;
+    s.active_receptors_.insert( c );
+  }
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+inline bool
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::receptor_active( const Parameters& p, State& s, const size_t c )
+{
+  if ( std::abs( s.y1_[ c ] ) > p.receptor_tol_ or std::abs( s.y2_[ c ] ) > p.receptor_tol_ )
+  {
+    return true;
+  }
+  s.y1_[ c ] = 0.0;
+  s.y2_[ c ] = 0.0;
+  return false;
+}
+
+template < class TReset, class TASC, class TThreshold, class TSynapse >
+size_t
+glif_kernel< TReset, TASC, TThreshold, TSynapse >::step( Neuron neurons[],
+  const Input inputs[],
+  const size_t n,
+  const double dt,
+  double spike_offsets[] )
+{
+  size_t n_spikes = 0;
+  for ( size_t i = 0; i < n; ++i )
+  {
+    Neuron& nrn = neurons[ i ];
+    if ( nrn.v_.h_ != dt )
+    {
+      propagators( nrn.p_, dt, nrn.v_ );
+    }
+
+    nrn.s_.I_ = inputs[ i ].I_;
+    double spike_offset = -1.0;
+    bool spiked;
+    if ( nrn.v_.spike_time_method_ == glif_spike_time_linear )
+    {
+      spiked = step< TASC::enabled, TThreshold::enabled >(
+        nrn.p_, nrn.v_, nrn.s_, nrn.s_.V_m_, nrn.s_.threshold_, spike_offset );
+    }
+    else
+    {
+      const State s_start = nrn.s_;
+      spiked = step< TASC::enabled, TThreshold::enabled >(
+        nrn.p_, nrn.v_, nrn.s_, nrn.s_.V_m_, nrn.s_.threshold_, spike_offset );
+      spiked = locate_crossing< TASC::enabled, TThreshold::enabled >(
+        nrn.p_, nrn.v_, s_start, nrn.s_, spiked, spike_offset );
+    }
+    if ( spiked )
+    {
+      ++n_spikes;
+    }
+    spike_offsets[ i ] = spike_offset;
+
+    // Apply spikes arriving at the end of the step
+    for ( size_t r = 0; r < inputs[ i ].spikes_.size() && r < nrn.v_.receptor_class_.size(); ++r )
+    {
+      add_spikes( nrn.v_, nrn.s_, nrn.v_.receptor_class_[ r ], inputs[ i ].spikes_[ r ] );
+    }
+  }
+  return n_spikes;
+}
+
+} // namespace
+
+#endif
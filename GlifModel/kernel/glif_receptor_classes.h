@@ -0,0 +1,48 @@
+#ifndef GLIF_RECEPTOR_CLASSES_H
+#define GLIF_RECEPTOR_CLASSES_H
+
+// C++ includes:
+#include <cstddef>
+#include <vector>
+
+namespace nest
+{
+
+/**
+ * Sorts the receptor ports into classes of equal synaptic time constant
+ * tau_syn, and of equal reversal potential E_rev unless E_rev is empty. The
+ * synaptic states of the ports of a class evolve with the same propagators
+ * and enter V_m alike, so that the sum of their states evolves as the state
+ * of a single port that receives the spikes of all of them. The models
+ * therefore keep one state per class and add the spikes arriving at port i
+ * to class receptor_class[ i ]. first_port[ c ] is the first port of class c,
+ * whose tau_syn and E_rev are those of the class.
+ */
+inline void
+glif_receptor_classes( const std::vector< double >& tau_syn,
+  const std::vector< double >& E_rev,
+  std::vector< size_t >& receptor_class,
+  std::vector< size_t >& first_port )
+{
+  receptor_class.resize( tau_syn.size() );
+  first_port.clear();
+  for ( size_t i = 0; i < tau_syn.size(); ++i )
+  {
+    size_t c = 0;
+    while ( c < first_port.size()
+      and ( tau_syn[ first_port[ c ] ] != tau_syn[ i ]
+            or ( not E_rev.empty() and E_rev[ first_port[ c ] ] != E_rev[ i ] ) ) )
+    {
+      ++c;
+    }
+    if ( c == first_port.size() )
+    {
+      first_port.push_back( i );
+    }
+    receptor_class[ i ] = c;
+  }
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,295 @@
+#ifndef GLIF_SMALL_VECTOR_H
+#define GLIF_SMALL_VECTOR_H
+
+// C++ includes:
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace nest
+{
+
+/**
+ * Vector of doubles (or other trivially copyable values) that keeps up to N
+ * elements inline and falls back to the heap for more. The after-spike
+ * currents (almost always 2) and the per-receptor states and propagators
+ * (rarely more than 4) thus live inside the neuron, instead of in a separate
+ * heap allocation each.
+ *
+ * It offers the subset of the std::vector interface used by the models and
+ * converts from and to std::vector, so that it can be read from and written
+ * to status dictionaries with def< std::vector< double > > and
+ * updateValue< std::vector< double > >.
+ */
+template < typename T, size_t N >
+class glif_small_vector
+{
+public:
+  typedef T value_type;
+  typedef T* iterator;
+  typedef const T* const_iterator;
+
+  glif_small_vector()
+    : data_( inline_ )
+    , size_( 0 )
+    , capacity_( N )
+  {
+  }
+
+  explicit glif_small_vector( size_t n, const T& value = T() )
+    : data_( inline_ )
+    , size_( 0 )
+    , capacity_( N )
+  {
+    resize( n, value );
+  }
+
+  glif_small_vector( const std::vector< T >& v )
+    : data_( inline_ )
+    , size_( 0 )
+    , capacity_( N )
+  {
+    assign_( v.begin(), v.end() );
+  }
+
+  glif_small_vector( const glif_small_vector& v )
+    : data_( inline_ )
+    , size_( 0 )
+    , capacity_( N )
+  {
+    assign_( v.begin(), v.end() );
+  }
+
+  ~glif_small_vector()
+  {
+    if ( data_ != inline_ )
+    {
+      delete[] data_;
+    }
+  }
+
+  glif_small_vector& operator=( const glif_small_vector& v )
+  {
+    if ( this != &v )
+    {
+      assign_( v.begin(), v.end() );
+    }
+    return *this;
+  }
+
+  glif_small_vector& operator=( const std::vector< T >& v )
+  {
+    assign_( v.begin(), v.end() );
+    return *this;
+  }
+
+  operator std::vector< T >() const
+  {
+    return std::vector< T >( begin(), end() );
+  }
+
+  size_t
+  size() const
+  {
+    return size_;
+  }
+
+  bool
+  empty() const
+  {
+    return size_ == 0;
+  }
+
+  //! Removes all elements, but keeps the storage
+  void
+  clear()
+  {
+    size_ = 0;
+  }
+
+  void
+  resize( size_t n, const T& value = T() )
+  {
+    reserve_( n );
+    if ( n > size_ )
+    {
+      std::fill( data_ + size_, data_ + n, value );
+    }
+    size_ = n;
+  }
+
+  T& operator[]( size_t i )
+  {
+    return data_[ i ];
+  }
+
+  const T& operator[]( size_t i ) const
+  {
+    return data_[ i ];
+  }
+
+  iterator
+  begin()
+  {
+    return data_;
+  }
+
+  iterator
+  end()
+  {
+    return data_ + size_;
+  }
+
+  const_iterator
+  begin() const
+  {
+    return data_;
+  }
+
+  const_iterator
+  end() const
+  {
+    return data_ + size_;
+  }
+
+private:
+  //! Moves the elements to the heap if more than the current capacity are needed
+  void
+  reserve_( size_t n )
+  {
+    if ( n <= capacity_ )
+    {
+      return;
+    }
+    T* data = new T[ n ];
+    std::copy( begin(), end(), data );
+    if ( data_ != inline_ )
+    {
+      delete[] data_;
+    }
+    data_ = data;
+    capacity_ = n;
+  }
+
+  template < typename InputIterator >
+  void
+  assign_( InputIterator first, InputIterator last )
+  {
+    const size_t n = std::distance( first, last );
+    size_ = 0;
+    reserve_( n );
+    std::copy( first, last, data_ );
+    size_ = n;
+  }
+
+  T* data_;         //!< inline_ or heap storage
+  size_t size_;     //!< number of elements
+  size_t capacity_; //!< number of elements data_ can hold
+  T inline_[ N ];   //!< inline storage of the first N elements
+};
+
+/**
+ * Always empty stand-in for glif_small_vector, used by glif_neuron for the
+ * after-spike currents and receptors of models without them. Its size is a
+ * compile-time 0, so that the loops over it are removed by the compiler, and
+ * it holds no storage.
+ */
+template < typename T >
+class glif_empty_vector
+{
+public:
+  typedef T value_type;
+  typedef T* iterator;
+  typedef const T* const_iterator;
+
+  glif_empty_vector()
+  {
+  }
+
+  explicit glif_empty_vector( size_t n, const T& = T() )
+  {
+    assert( n == 0 );
+  }
+
+  glif_empty_vector( const std::vector< T >& v )
+  {
+    assert( v.empty() );
+  }
+
+  glif_empty_vector& operator=( const std::vector< T >& v )
+  {
+    assert( v.empty() );
+    return *this;
+  }
+
+  operator std::vector< T >() const
+  {
+    return std::vector< T >();
+  }
+
+  static constexpr size_t
+  size()
+  {
+    return 0;
+  }
+
+  static constexpr bool
+  empty()
+  {
+    return true;
+  }
+
+  void
+  clear()
+  {
+  }
+
+  void
+  resize( size_t n, const T& = T() )
+  {
+    assert( n == 0 );
+  }
+
+  //! Never called, since there is no element
+  T& operator[]( size_t )
+  {
+    assert( false );
+    return *static_cast< T* >( nullptr );
+  }
+
+  const T& operator[]( size_t ) const
+  {
+    assert( false );
+    return *static_cast< const T* >( nullptr );
+  }
+
+  iterator
+  begin()
+  {
+    return nullptr;
+  }
+
+  iterator
+  end()
+  {
+    return nullptr;
+  }
+
+  const_iterator
+  begin() const
+  {
+    return nullptr;
+  }
+
+  const_iterator
+  end() const
+  {
+    return nullptr;
+  }
+};
+
+} // namespace
+
+#endif
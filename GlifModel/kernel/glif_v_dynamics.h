@@ -0,0 +1,94 @@
+#ifndef GLIF_V_DYNAMICS_H
+#define GLIF_V_DYNAMICS_H
+
+// C++ includes:
+#include <cmath>
+#include <cstddef>
+#include <string>
+
+namespace nest
+{
+
+/**
+ * Solution method of the voltage dynamics of the current-based models
+ * (Equation (1) in [1], see glif_neuron.h). With the input held constant over
+ * a step of length h, every method is a linear one-step map
+ *
+ *   V_m( t + h ) = P_V V_m( t ) + P30 ( I + G E_L ),
+ *
+ * so that calibrate() only computes P_V and P30 through the method's
+ * function and the update loop is the same branch-free expression for all
+ * methods. A method is added by adding an entry to glif_v_dynamics_methods.
+ * A full state method instead propagates V_m together with the after-spike
+ * currents, the voltage component of the threshold and the synaptic
+ * currents, see glif_kernel::Propagators::P_state_; its P_V and P30 only
+ * serve estimates.
+ */
+struct glif_v_dynamics_method
+{
+  //! value of the V_dynamics_method parameter
+  const char* name;
+
+  //! V_m is propagated in closed form between input changes and spikes
+  bool event_driven;
+
+  //! the linear state of the neuron is propagated by its matrix exponential
+  bool full_state;
+
+  //! Sets P_V and P30 for the step h in ms, conductance G in nS and
+  //! capacitance C_m in pF
+  void ( *propagators )( const double h, const double G, const double C_m, double& P_V, double& P30 );
+};
+
+//! Linear Euler forward (RK1)
+inline void
+glif_forward_euler_propagators( const double h, const double G, const double C_m, double& P_V, double& P30 )
+{
+  P_V = 1.0 - h * G / C_m;
+  P30 = h / C_m;
+}
+
+//! Linear second-order Runge-Kutta (Heun)
+inline void
+glif_rk2_propagators( const double h, const double G, const double C_m, double& P_V, double& P30 )
+{
+  const double x = h * G / C_m;
+  P_V = 1.0 - x + 0.5 * x * x;
+  P30 = h / C_m * ( 1.0 - 0.5 * x );
+}
+
+//! Linear exact
+inline void
+glif_exact_propagators( const double h, const double G, const double C_m, double& P_V, double& P30 )
+{
+  P_V = std::exp( -h * G / C_m );
+  P30 = ( 1.0 - P_V ) / G;
+}
+
+//! All methods, the first is the default
+const glif_v_dynamics_method glif_v_dynamics_methods[] = {
+  { "linear_forward_euler", false, false, glif_forward_euler_propagators },
+  { "linear_rk2", false, false, glif_rk2_propagators },
+  { "linear_exact", false, false, glif_exact_propagators },
+  { "linear_exact_event_driven", true, false, glif_exact_propagators },
+  { "matrix_exponential", false, true, glif_exact_propagators },
+};
+
+//! Method of the given name, 0 for unknown names
+inline const glif_v_dynamics_method*
+glif_find_v_dynamics_method( const std::string& name )
+{
+  const size_t n = sizeof( glif_v_dynamics_methods ) / sizeof( glif_v_dynamics_methods[ 0 ] );
+  for ( size_t i = 0; i < n; ++i )
+  {
+    if ( name == glif_v_dynamics_methods[ i ].name )
+    {
+      return &glif_v_dynamics_methods[ i ];
+    }
+  }
+  return 0;
+}
+
+} // namespace
+
+#endif
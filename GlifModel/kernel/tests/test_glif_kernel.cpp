@@ -0,0 +1,208 @@
+/*
+ * Tests of the kernel library, built and run with ctest when the library is
+ * built on its own:
+ *
+ *   cmake -S GlifModel/kernel -B build && cmake --build build && ctest --test-dir build
+ */
+
+// C++ includes:
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "glif_kernel.h"
+
+using namespace nest;
+
+typedef glif_lif_r_asc_a_psc_kernel Kernel;
+
+namespace
+{
+
+int failures = 0;
+
+void
+check( const bool condition, const char* what )
+{
+  if ( not condition )
+  {
+    std::printf( "FAILED: %s\n", what );
+    ++failures;
+  }
+}
+
+//! A neuron with the given synaptic time constants, calibrated for dt
+void
+make_neuron( Kernel::Neuron& nrn, const std::vector< double >& tau_syn, const double dt )
+{
+  nrn.p_.tau_syn_ = tau_syn;
+  nrn.p_.th_inf_ = -60.0;
+  nrn.p_.E_L_ = -70.0;
+  nrn.p_.a_voltage_ = 0.01;
+  nrn.p_.b_voltage_ = 0.3;
+  Kernel::calibrate( nrn, dt );
+  nrn.s_.V_m_ = nrn.p_.E_L_;
+  nrn.s_.threshold_ = nrn.p_.th_inf_;
+}
+
+/*
+ * Ports of equal tau_syn share a receptor class. Spikes arriving through the
+ * batched step() at any port, also at one after the merged ports, must reach
+ * the state of its class: the neuron behaves as one with a port per class.
+ */
+void
+test_merged_receptor_ports()
+{
+  const double dt = 0.1;
+  const double tau_merged[] = { 2.0, 2.0, 5.0, 2.0, 7.0 };
+  const double tau_distinct[] = { 2.0, 5.0, 7.0 };
+  const size_t port_class[] = { 0, 0, 1, 0, 2 };
+
+  Kernel::Neuron neurons[ 2 ];
+  make_neuron( neurons[ 0 ], std::vector< double >( tau_merged, tau_merged + 5 ), dt );
+  make_neuron( neurons[ 1 ], std::vector< double >( tau_distinct, tau_distinct + 3 ), dt );
+  check( neurons[ 0 ].v_.class_port_.size() == 3, "ports of equal tau_syn share a class" );
+
+  Kernel::Input inputs[ 2 ];
+  inputs[ 0 ].spikes_.resize( 5 );
+  inputs[ 1 ].spikes_.resize( 3 );
+  double spike_offsets[ 2 ];
+  size_t n_spikes[ 2 ] = { 0, 0 };
+  double max_dV = 0.0;
+  for ( long k = 0; k < 20000; ++k )
+  {
+    std::fill( inputs[ 0 ].spikes_.begin(), inputs[ 0 ].spikes_.end(), 0.0 );
+    std::fill( inputs[ 1 ].spikes_.begin(), inputs[ 1 ].spikes_.end(), 0.0 );
+    if ( k % 37 == 0 )
+    {
+      const size_t port = ( k / 37 ) % 5;
+      const double weight = 40.0 + port;
+      inputs[ 0 ].spikes_[ port ] = weight;
+      inputs[ 1 ].spikes_[ port_class[ port ] ] = weight;
+    }
+    for ( size_t i = 0; i < 2; ++i )
+    {
+      Kernel::step( &neurons[ i ], &inputs[ i ], 1, dt, &spike_offsets[ i ] );
+      if ( spike_offsets[ i ] >= 0.0 )
+      {
+        ++n_spikes[ i ];
+      }
+    }
+    max_dV = std::max( max_dV, std::abs( neurons[ 0 ].s_.V_m_ - neurons[ 1 ].s_.V_m_ ) );
+  }
+  check( n_spikes[ 0 ] > 0, "merged ports drive the neuron to spike" );
+  check( n_spikes[ 0 ] == n_spikes[ 1 ], "merged ports spike as distinct ports" );
+  check( max_dV == 0.0, "merged ports give the V_m of distinct ports" );
+}
+
+/*
+ * The synaptic state of a class cannot be split among other classes: it is
+ * kept while calibrate() finds the same classes and reset when tau_syn
+ * changed the classes.
+ */
+void
+test_receptor_class_change()
+{
+  const double dt = 0.1;
+  const double tau_syn[] = { 2.0, 2.0, 5.0 };
+
+  Kernel::Neuron nrn;
+  make_neuron( nrn, std::vector< double >( tau_syn, tau_syn + 3 ), dt );
+  Kernel::add_spikes( nrn.v_, nrn.s_, nrn.v_.receptor_class_[ 2 ], 10.0 );
+  const double y1 = nrn.s_.y1_[ nrn.v_.receptor_class_[ 2 ] ];
+
+  nrn.p_.tau_syn_[ 2 ] = 7.0;
+  check( not Kernel::calibrate( nrn.p_, dt, nrn.v_, nrn.s_ ), "equal classes are kept" );
+  check( nrn.s_.y1_[ nrn.v_.receptor_class_[ 2 ] ] == y1, "the state of equal classes is kept" );
+
+  nrn.p_.tau_syn_[ 1 ] = 7.0;
+  check( Kernel::calibrate( nrn.p_, dt, nrn.v_, nrn.s_ ), "changed classes are reported" );
+  check( nrn.s_.y1_.size() == 2 and nrn.s_.y1_[ 0 ] == 0.0 and nrn.s_.y1_[ 1 ] == 0.0,
+    "the state of changed classes is reset" );
+  check( nrn.s_.active_receptors_.empty(), "changed classes are inactive" );
+}
+
+/*
+ * With the matrix exponential, distance_to_threshold() evaluates the Taylor
+ * basis of crossing_basis() instead of propagating the state over t, also
+ * across several sub-steps; both must agree to round-off.
+ */
+void
+test_crossing_basis()
+{
+  const double h = 1.0;
+  const double tau_syn[] = { 0.3, 2.0, 2.0, 5.0 };
+
+  Kernel::Neuron nrn;
+  nrn.p_.V_dynamics_method_ = "matrix_exponential";
+  nrn.p_.k_.assign( 2, 0.3 );
+  nrn.p_.k_[ 1 ] = 0.05;
+  nrn.p_.asc_amps_.assign( 2, -10.0 );
+  nrn.p_.r_.assign( 2, 1.0 );
+  nrn.p_.asc_init_.assign( 2, 0.0 );
+  make_neuron( nrn, std::vector< double >( tau_syn, tau_syn + 4 ), h );
+  nrn.s_.ASCurrents_.resize( 2 );
+  nrn.s_.ASCurrents_[ 0 ] = -20.0;
+  nrn.s_.ASCurrents_[ 1 ] = 5.0;
+  nrn.s_.I_ = 150.0;
+  nrn.s_.last_spike_ = 2.0;
+  nrn.s_.last_voltage_ = 0.5;
+  nrn.s_.threshold_ = nrn.p_.th_inf_ + nrn.s_.last_spike_ + nrn.s_.last_voltage_;
+  for ( size_t c = 0; c < nrn.v_.tau_syn_.size(); ++c )
+  {
+    Kernel::add_spikes( nrn.v_, nrn.s_, c, 30.0 );
+  }
+
+  Kernel::crossing_basis( nrn.p_, nrn.v_, nrn.s_, h );
+  check( nrn.v_.crossing_basis_.size() > glif_crossing_basis_order, "the basis spans several sub-steps" );
+
+  Kernel::Propagators v_t = nrn.v_;
+  double max_df = 0.0;
+  for ( int k = 1; k <= 100; ++k )
+  {
+    const double t = k * h / 100.0;
+    const double f = Kernel::distance_to_threshold< true, true >( nrn.p_, nrn.v_, nrn.s_, t );
+
+    Kernel::propagators( nrn.p_, t, v_t );
+    Kernel::State s_t = nrn.s_;
+    double spike_offset;
+    Kernel::step< true, true >( nrn.p_, v_t, s_t, s_t.V_m_, s_t.threshold_, spike_offset );
+    max_df = std::max( max_df, std::abs( f - ( s_t.V_m_ - s_t.threshold_ ) ) );
+  }
+  check( max_df < 1e-10, "the crossing basis gives the propagated distance to the threshold" );
+}
+
+/*
+ * Every method of the table is found by its name, while unknown names are
+ * reported instead of falling back to a method of the table.
+ */
+void
+test_v_dynamics_method_names()
+{
+  const size_t n = sizeof( glif_v_dynamics_methods ) / sizeof( glif_v_dynamics_methods[ 0 ] );
+  for ( size_t i = 0; i < n; ++i )
+  {
+    check( glif_find_v_dynamics_method( glif_v_dynamics_methods[ i ].name ) == &glif_v_dynamics_methods[ i ],
+      "the methods are found by their names" );
+  }
+  check( glif_find_v_dynamics_method( "matrix_exponental" ) == 0, "unknown methods are not found" );
+}
+
+} // namespace
+
+int
+main()
+{
+  test_merged_receptor_ports();
+  test_receptor_class_change();
+  test_crossing_basis();
+  test_v_dynamics_method_names();
+
+  if ( failures > 0 )
+  {
+    std::printf( "%d checks failed\n", failures );
+    return 1;
+  }
+  return 0;
+}
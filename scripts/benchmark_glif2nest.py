@@ -0,0 +1,579 @@
+"""
+Accuracy and performance benchmarks of the NEST glif models. The benchmarks use the default model parameters
+together with generated synaptic/current input, so no Cell-Types-DB download is required.
+ex:
+List the available benchmarks
+    $ python benchmark_glif2nest.py --list-benchmarks
+
+Compare the 'exponential_integrator' against the 'gsl_rkf45' voltage dynamics method of all conductance-based models
+    $ python benchmark_glif2nest.py -b cond-methods
+
+Same comparison at a coarser resolution for the glif_lif_r_asc_a_cond model only
+    $ python benchmark_glif2nest.py -b cond-methods -m glif_lif_r_asc_a_cond --dt 0.1
+
+Throughput (simulation steps per second) of the GSL solvers under strong (stiff) conductance input
+    $ python benchmark_glif2nest.py -b cond-solvers
+
+Sweep of the GSL error tolerances and maximal step size: spike time error against the tightest setting versus wall time
+    $ python benchmark_glif2nest.py -b cond-tolerances
+
+Resident memory per neuron of the cond models (run it on different versions of the module to compare)
+    $ python benchmark_glif2nest.py -b cond-memory
+
+Wall time of networks with 10% active and 90% resting neurons with and without the quiescence fast path
+    $ python benchmark_glif2nest.py -b quiescence --dt 0.1
+
+Spike time deviation and speed-up of the 'linear_exact_event_driven' against the 'linear_exact' voltage dynamics method
+under step current input
+    $ python benchmark_glif2nest.py -b event-driven -t 10000.0
+
+Simulated neuron steps per second of all models under noisy current input (run it on different versions of the module
+to compare, e.g. before and after a change of the update loop)
+    $ python benchmark_glif2nest.py -b throughput
+
+Simulated neuron steps per second of glif_lif_psc_population against separate glif_lif_psc nodes for several numbers
+of neurons
+    $ python benchmark_glif2nest.py -b population -t 100.0
+
+Spike time error of the psc models and their precise spike timing (_ps) variants at the default and a coarse
+resolution, against the _ps variant at 0.001 ms, under off-grid spike input
+    $ python benchmark_glif2nest.py -b precise-timing -t 1000.0
+
+Spike time error of the 'linear', 'hermite' and 'exact' spike time methods of the plain and psc models for
+resolutions from 0.01 to 1.0 ms against 'exact' at 0.001 ms, and per method the coarsest resolution within 0.01 ms
+    $ python benchmark_glif2nest.py -b spike-time-methods -t 1000.0
+
+Spike time error and speed-up of the plain and psc models at a resolution of 0.1 ms, with and without integration
+sub-steps of 0.005 ms, against the models at a resolution of 0.005 ms
+    $ python benchmark_glif2nest.py -b substeps --dt 0.005
+
+Resident memory per neuron and simulation speed of 1M neurons replicated from 100 parameter sets (run it on different
+versions of the module to compare; for cache statistics run it under 'perf stat -e cache-misses,cache-references')
+    $ python benchmark_glif2nest.py -b parameter-sharing -m glif_lif_r_asc_a_psc -t 100.0
+
+L1 and L2 data cache miss rates of the update of a 100k neuron recurrent network, measured with linux perf attached
+to the process during Simulate only (run it on different versions of the module to compare; other perf events can be
+given as a comma separated list with --perf-events)
+    $ python benchmark_glif2nest.py -b cache -t 100.0
+"""
+
+from optparse import OptionParser
+import os
+import signal
+import subprocess
+import time
+import numpy as np
+
+import nest
+
+nest.Install('glifmodule.so')
+
+all_models = ['glif_lif', 'glif_lif_r', 'glif_lif_asc', 'glif_lif_r_asc', 'glif_lif_r_asc_a',
+              'glif_lif_psc', 'glif_lif_r_psc', 'glif_lif_asc_psc', 'glif_lif_r_asc_psc', 'glif_lif_r_asc_a_psc',
+              'glif_lif_cond', 'glif_lif_r_cond', 'glif_lif_asc_cond', 'glif_lif_r_asc_cond', 'glif_lif_r_asc_a_cond']
+cond_models = ['glif_lif_cond', 'glif_lif_r_cond', 'glif_lif_asc_cond', 'glif_lif_r_asc_cond', 'glif_lif_r_asc_a_cond']
+ps_models = ['glif_lif_psc_ps', 'glif_lif_r_psc_ps', 'glif_lif_asc_psc_ps', 'glif_lif_r_asc_psc_ps', 'glif_lif_r_asc_a_psc_ps']
+
+
+def run_cond_network(model, params, dt, simulation_time, n_neurons=100, rate=2000.0, weight=5.0, I_e=150.0, seed=1234):
+    """Simulates n_neurons unconnected cond neurons driven by poisson input on an excitatory and an inhibitory port
+
+    Parameters
+    ----------
+    model : name of the glif cond model
+    params : dictionary of parameters that are set on every neuron
+    dt : simulation resolution in ms
+    simulation_time : simulated time in ms
+    n_neurons : number of neurons
+    rate : rate of the poisson input to each port in Hz
+    weight : synaptic weight of the poisson input in nS
+    I_e : amplitude of a constant input current in pA
+
+    Returns
+    -------
+    A dictionary with the voltage traces ('voltages'), a list of spike times per neuron ('spike_times') and the wall
+    time spent in nest.Simulate ('wall_time')
+    """
+    nest.ResetKernel()
+    nest.SetKernelStatus({'resolution': dt, 'grng_seed': seed, 'rng_seeds': [seed + 1]})
+
+    neurons = nest.Create(model, n_neurons, params=dict({'tau_syn': [2.0, 1.0], 'E_rev': [0.0, -85.0]}, **params))
+    for port in [1, 2]:
+        pg = nest.Create('poisson_generator', params={'rate': rate})
+        parrots = nest.Create('parrot_neuron', n_neurons)
+        nest.Connect(pg, parrots)
+        nest.Connect(parrots, neurons, 'one_to_one', syn_spec={'weight': weight, 'delay': 1.0, 'receptor_type': port})
+
+    dc = nest.Create('dc_generator', params={'amplitude': I_e})
+    nest.Connect(dc, neurons)
+
+    voltmeter = nest.Create('voltmeter', params={'withgid': True, 'withtime': True, 'interval': dt})
+    nest.Connect(voltmeter, neurons)
+    spikedetector = nest.Create('spike_detector', params={'withgid': True, 'withtime': True})
+    nest.Connect(neurons, spikedetector)
+
+    start = time.time()
+    nest.Simulate(simulation_time)
+    wall_time = time.time() - start
+
+    v_events = nest.GetStatus(voltmeter)[0]['events']
+    voltages = np.array([v_events['V_m'][v_events['senders'] == n] for n in neurons])
+    s_events = nest.GetStatus(spikedetector)[0]['events']
+    spike_times = [np.sort(s_events['times'][s_events['senders'] == n]) for n in neurons]
+
+    return {'voltages': voltages, 'spike_times': spike_times, 'wall_time': wall_time}
+
+
+def spike_time_error(spikes, spikes_ref):
+    """Returns the mean absolute spike time difference between two lists of spike trains and the number of neurons
+    whose spike count differs"""
+    diffs = []
+    n_count_mismatch = 0
+    for s, s_ref in zip(spikes, spikes_ref):
+        if len(s) != len(s_ref):
+            n_count_mismatch += 1
+            continue
+        diffs.extend(np.abs(s - s_ref))
+    return (np.mean(diffs) if len(diffs) > 0 else 0.0), n_count_mismatch
+
+
+def benchmark_cond_methods(models, dt, simulation_time):
+    """Compares the 'exponential_integrator' voltage dynamics method of the cond models against the 'gsl_rkf45'
+    reference, reports voltage and spike time deviations and the speed-up"""
+    print('{:<24} {:>12} {:>14} {:>10} {:>12} {:>12} {:>9}'.format(
+        'model', 'max |dV| mV', 'mean |dt_s| ms', 'n_spikes', 'count diff', 'rkf45 s', 'speed-up'))
+    for model in models:
+        ref = run_cond_network(model, {'V_dynamics_method': 'gsl_rkf45'}, dt, simulation_time)
+        out = run_cond_network(model, {'V_dynamics_method': 'exponential_integrator'}, dt, simulation_time)
+
+        max_dv = np.max(np.abs(out['voltages'] - ref['voltages']))
+        mean_dt, n_mismatch = spike_time_error(out['spike_times'], ref['spike_times'])
+        n_spikes = sum(len(s) for s in ref['spike_times'])
+        print('{:<24} {:>12.2e} {:>14.2e} {:>10d} {:>12d} {:>12.3f} {:>9.1f}'.format(
+            model, max_dv, mean_dt, n_spikes, n_mismatch, ref['wall_time'], ref['wall_time'] / out['wall_time']))
+
+
+def benchmark_cond_solvers(models, dt, simulation_time, n_neurons=100, rate=20000.0, weight=50.0):
+    """Runs the cond models with every GSL solver under high-conductance poisson input and reports the number of
+    simulated neuron steps per wall-clock second and the deviation of V_m from the 'rkf45' solver"""
+    solvers = ['rkf45', 'rk2imp', 'rk4imp', 'bsimp', 'gear2']
+    n_steps = n_neurons * int(round(simulation_time / dt))
+    print('{:<24} {:>8} {:>14} {:>12}'.format('model', 'solver', 'steps/s', 'max |dV| mV'))
+    for model in models:
+        ref = None
+        for solver in solvers:
+            out = run_cond_network(model, {'V_dynamics_method': 'gsl_rkf45', 'solver': solver}, dt, simulation_time,
+                                   n_neurons=n_neurons, rate=rate, weight=weight)
+            if ref is None:
+                ref = out
+            max_dv = np.max(np.abs(out['voltages'] - ref['voltages']))
+            print('{:<24} {:>8} {:>14.0f} {:>12.2e}'.format(model, solver, n_steps / out['wall_time'], max_dv))
+
+
+def benchmark_cond_tolerances(models, dt, simulation_time, n_neurons=100):
+    """Sweeps the GSL error tolerances and maximal step size of the cond models and reports the spike time error
+    against the tightest setting together with the wall time per simulated neuron-second"""
+    # (gsl_abs_tol, gsl_rel_tol, gsl_max_step), the first entry is the reference
+    settings = [(1e-8, 1e-8, 0.01), (1e-6, 0.0, np.inf), (1e-5, 0.0, np.inf), (1e-4, 0.0, np.inf),
+                (1e-3, 0.0, np.inf), (1e-2, 0.0, np.inf), (1e-1, 0.0, np.inf), (1e-3, 1e-3, np.inf)]
+    neuron_seconds = n_neurons * simulation_time / 1000.0
+    print('{:<24} {:>8} {:>8} {:>9} {:>14} {:>11} {:>16}'.format(
+        'model', 'abs_tol', 'rel_tol', 'max_step', 'mean |dt_s| ms', 'count diff', 'wall s/neuron-s'))
+    for model in models:
+        ref = None
+        for abs_tol, rel_tol, max_step in settings:
+            params = {'V_dynamics_method': 'gsl_rkf45', 'gsl_abs_tol': abs_tol, 'gsl_rel_tol': rel_tol,
+                      'gsl_max_step': max_step}
+            out = run_cond_network(model, params, dt, simulation_time, n_neurons=n_neurons)
+            if ref is None:
+                ref = out
+            mean_dt, n_mismatch = spike_time_error(out['spike_times'], ref['spike_times'])
+            print('{:<24} {:>8.0e} {:>8.0e} {:>9} {:>14.2e} {:>11d} {:>16.2e}'.format(
+                model, abs_tol, rel_tol, max_step, mean_dt, n_mismatch, out['wall_time'] / neuron_seconds))
+
+
+def resident_memory():
+    """Returns the resident set size of this process in kB (linux only)"""
+    with open('/proc/self/status') as f:
+        for line in f:
+            if line.startswith('VmRSS:'):
+                return int(line.split()[1])
+    return 0
+
+
+def benchmark_cond_memory(models, dt, simulation_time, n_neurons=100000):
+    """Reports the resident memory per cond neuron after creating and calibrating n_neurons neurons with two receptor
+    ports, for the GSL and the GSL-free voltage dynamics method"""
+    print('{:<24} {:>24} {:>14}'.format('model', 'V_dynamics_method', 'bytes/neuron'))
+    for model in models:
+        for method in ['gsl_rkf45', 'exponential_integrator']:
+            nest.ResetKernel()
+            nest.SetKernelStatus({'resolution': dt})
+            mem_start = resident_memory()
+            nest.Create(model, n_neurons, params={'tau_syn': [2.0, 1.0], 'E_rev': [0.0, -85.0],
+                                                  'V_dynamics_method': method})
+            nest.Simulate(dt)  # calibrates all neurons
+            mem_used = (resident_memory() - mem_start) * 1024.0
+            print('{:<24} {:>24} {:>14.0f}'.format(model, method, mem_used / n_neurons))
+
+
+def run_sparse_network(model, dt, simulation_time, n_neurons=1000, active_fraction=0.1, idle_current=0.0, seed=1234):
+    """Simulates n_neurons unconnected neurons of which only active_fraction receive a noisy input current, while the
+    others start at their resting potential and receive the constant current idle_current
+
+    Returns
+    -------
+    The wall time spent in nest.Simulate
+    """
+    nest.ResetKernel()
+    nest.SetKernelStatus({'resolution': dt, 'grng_seed': seed, 'rng_seeds': [seed + 1]})
+
+    neurons = nest.Create(model, n_neurons)
+    for n in neurons:
+        nest.SetStatus([n], {'V_m': nest.GetStatus([n], 'E_L')[0]})
+    n_active = int(round(active_fraction * n_neurons))
+    active, idle = neurons[:n_active], neurons[n_active:]
+
+    noise = nest.Create('noise_generator', params={'mean': 200.0, 'std': 100.0, 'dt': 1.0})
+    nest.Connect(noise, active)
+    if idle_current != 0.0 and len(idle) > 0:
+        dc = nest.Create('dc_generator', params={'amplitude': idle_current})
+        nest.Connect(dc, idle)
+
+    start = time.time()
+    nest.Simulate(simulation_time)
+    return time.time() - start
+
+
+def benchmark_quiescence(models, dt, simulation_time, n_neurons=1000, active_fraction=0.1):
+    """Reports the wall time of networks in which only active_fraction of the neurons receive input. In the baseline
+    the resting neurons receive a negligible current, which keeps them out of the quiescence fast path"""
+    print('{:<24} {:>12} {:>14} {:>9}'.format('model', 'baseline s', 'fast path s', 'speed-up'))
+    for model in models:
+        baseline = run_sparse_network(model, dt, simulation_time, n_neurons, active_fraction, idle_current=1e-9)
+        fast = run_sparse_network(model, dt, simulation_time, n_neurons, active_fraction)
+        print('{:<24} {:>12.3f} {:>14.3f} {:>9.1f}'.format(model, baseline, fast, baseline / fast))
+
+
+def run_step_current_network(model, params, dt, simulation_time, n_neurons=100, step_interval=200.0, seed=1234,
+                             first_step=None):
+    """Simulates n_neurons unconnected neurons each driven by a step_current_generator whose amplitude changes every
+    step_interval ms to a random value, first at first_step ms (default dt)
+
+    Returns
+    -------
+    A dictionary with a list of spike times and offsets per neuron ('spike_times') and the wall time spent in
+    nest.Simulate ('wall_time')
+    """
+    nest.ResetKernel()
+    nest.SetKernelStatus({'resolution': dt})
+
+    rng = np.random.RandomState(seed)
+    neurons = nest.Create(model, n_neurons, params=params)
+    times = np.arange(dt if first_step is None else first_step, simulation_time, step_interval)
+    for n in neurons:
+        scg = nest.Create('step_current_generator', params={'amplitude_times': times,
+                                                            'amplitude_values': rng.uniform(0.0, 300.0, len(times))})
+        nest.Connect(scg, [n])
+
+    spikedetector = nest.Create('spike_detector', params={'withgid': True, 'withtime': True,
+                                                          'precise_times': True})
+    nest.Connect(neurons, spikedetector)
+
+    start = time.time()
+    nest.Simulate(simulation_time)
+    wall_time = time.time() - start
+
+    s_events = nest.GetStatus(spikedetector)[0]['events']
+    spike_times = [np.sort(s_events['times'][s_events['senders'] == n]) for n in neurons]
+
+    return {'spike_times': spike_times, 'wall_time': wall_time}
+
+
+def benchmark_event_driven(models, dt, simulation_time):
+    """Compares the 'linear_exact_event_driven' voltage dynamics method against 'linear_exact' under step current
+    input, reports the spike time deviation and the speed-up"""
+    print('{:<24} {:>10} {:>14} {:>12} {:>12} {:>9}'.format(
+        'model', 'n_spikes', 'mean |dt_s| ms', 'count diff', 'exact s', 'speed-up'))
+    for model in models:
+        ref = run_step_current_network(model, {'V_dynamics_method': 'linear_exact'}, dt, simulation_time)
+        out = run_step_current_network(model, {'V_dynamics_method': 'linear_exact_event_driven'}, dt,
+                                       simulation_time)
+
+        mean_dt, n_mismatch = spike_time_error(out['spike_times'], ref['spike_times'])
+        n_spikes = sum(len(s) for s in ref['spike_times'])
+        print('{:<24} {:>10d} {:>14.2e} {:>12d} {:>12.3f} {:>9.1f}'.format(
+            model, n_spikes, mean_dt, n_mismatch, ref['wall_time'], ref['wall_time'] / out['wall_time']))
+
+
+def run_precise_input_network(model, dt, simulation_time, n_neurons=100, rate=2000.0, weight=200.0, I_dc=600.0,
+                               seed=1234):
+    """Simulates n_neurons unconnected neurons under a constant current and excitatory and inhibitory spikes at off-grid
+    times, which are drawn independently of the resolution
+
+    Returns
+    -------
+    A dictionary with a list of spike times and offsets per neuron ('spike_times') and the wall time spent in
+    nest.Simulate ('wall_time')
+    """
+    nest.ResetKernel()
+    nest.SetKernelStatus({'resolution': dt})
+
+    rng = np.random.RandomState(seed)
+    neurons = nest.Create(model, n_neurons)
+    dc = nest.Create('dc_generator', params={'amplitude': I_dc})
+    nest.Connect(dc, neurons)
+    n_inputs = int(rate * simulation_time / 1000.0)
+    for n in neurons:
+        times = np.sort(rng.uniform(0.0, simulation_time, n_inputs))
+        weights = np.where(rng.uniform(size=n_inputs) < 0.8, weight, -weight)
+        sg = nest.Create('spike_generator', params={'spike_times': times[times > 0.0],
+                                                    'spike_weights': weights[times > 0.0],
+                                                    'precise_times': True})
+        nest.Connect(sg, [n], syn_spec={'receptor_type': 1})
+
+    spikedetector = nest.Create('spike_detector', params={'withgid': True, 'withtime': True,
+                                                          'precise_times': True})
+    nest.Connect(neurons, spikedetector)
+
+    start = time.time()
+    nest.Simulate(simulation_time)
+    wall_time = time.time() - start
+
+    s_events = nest.GetStatus(spikedetector)[0]['events']
+    spike_times = [np.sort(s_events['times'][s_events['senders'] == n]) for n in neurons]
+
+    return {'spike_times': spike_times, 'wall_time': wall_time}
+
+
+def benchmark_precise_timing(models, dt, simulation_time, coarse_dt=0.1, ref_dt=0.001):
+    """Compares the spike times of each precise spike timing model and of its grid-based model at the resolutions dt
+    and coarse_dt against the precise model at ref_dt, under off-grid spike input; reports the mean spike time error,
+    the number of neurons with a different spike count and the wall time"""
+    print('{:<24} {:>8} {:>14} {:>12} {:>10}'.format('model', 'dt', 'mean |dt_s| ms', 'count diff', 'wall s'))
+    for model in models:
+        ref = run_precise_input_network(model, ref_dt, simulation_time)
+        for m in [model[:-len('_ps')], model]:
+            for d in [dt, coarse_dt]:
+                out = run_precise_input_network(m, d, simulation_time)
+                mean_dt, n_mismatch = spike_time_error(out['spike_times'], ref['spike_times'])
+                print('{:<24} {:>8.3f} {:>14.2e} {:>12d} {:>10.3f}'.format(m, d, mean_dt, n_mismatch,
+                                                                          out['wall_time']))
+
+
+def benchmark_spike_time_methods(models, dt, simulation_time, dts=(0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0),
+                                 ref_dt=0.001, tolerance=0.01):
+    """Compares the spike times of each spike time method at the resolutions dts against the 'exact' method at ref_dt,
+    all with the 'linear_exact' voltage dynamics method, under step current input; reports the mean spike time error,
+    the number of neurons with a different spike count and the wall time, and per method the coarsest resolution at
+    which the mean error stays below tolerance ms without a different spike count"""
+    methods = ['linear', 'hermite', 'exact']
+    print('{:<24} {:>8} {:>8} {:>14} {:>12} {:>10}'.format('model', 'method', 'dt', 'mean |dt_s| ms', 'count diff',
+                                                           'wall s'))
+    for model in models:
+        ref = run_step_current_network(model, {'V_dynamics_method': 'linear_exact', 'spike_time_method': 'exact'},
+                                       ref_dt, simulation_time, step_interval=50.0, first_step=1.0)
+        max_dt = {}
+        for method in methods:
+            within = True
+            for d in dts:
+                out = run_step_current_network(model, {'V_dynamics_method': 'linear_exact', 'spike_time_method': method},
+                                               d, simulation_time, step_interval=50.0, first_step=1.0)
+                mean_dt, n_mismatch = spike_time_error(out['spike_times'], ref['spike_times'])
+                print('{:<24} {:>8} {:>8.3f} {:>14.2e} {:>12d} {:>10.3f}'.format(model, method, d, mean_dt,
+                                                                                n_mismatch, out['wall_time']))
+                within = within and mean_dt < tolerance and n_mismatch == 0
+                if within:
+                    max_dt[method] = d
+        print('{:<24} coarsest dt within {} ms: {}'.format(model, tolerance, ', '.join(
+            '{} {}'.format(method, max_dt.get(method, '-')) for method in methods)))
+
+
+def benchmark_substeps(models, dt, simulation_time, coarse_dt=0.1):
+    """Compares the spike times and wall time of each model at the coarse resolution coarse_dt, with and without
+    integration sub-steps of dt, against the model at the resolution dt, under step current input"""
+    substeps = int(round(coarse_dt / dt))
+    print('{:<24} {:>8} {:>10} {:>14} {:>12} {:>10} {:>9}'.format(
+        'model', 'dt', 'substeps', 'mean |dt_s| ms', 'count diff', 'wall s', 'speed-up'))
+    for model in models:
+        ref = run_step_current_network(model, {'V_dynamics_method': 'linear_exact'}, dt, simulation_time,
+                                       step_interval=50.0, first_step=coarse_dt)
+        print('{:<24} {:>8.3f} {:>10d} {:>14} {:>12} {:>10.3f} {:>9}'.format(model, dt, 1, '-', '-',
+                                                                            ref['wall_time'], '-'))
+        for n in [1, substeps]:
+            out = run_step_current_network(model, {'V_dynamics_method': 'linear_exact', 'integration_substeps': n},
+                                           coarse_dt, simulation_time, step_interval=50.0, first_step=coarse_dt)
+            mean_dt, n_mismatch = spike_time_error(out['spike_times'], ref['spike_times'])
+            print('{:<24} {:>8.3f} {:>10d} {:>14.2e} {:>12d} {:>10.3f} {:>9.1f}'.format(
+                model, coarse_dt, n, mean_dt, n_mismatch, out['wall_time'], ref['wall_time'] / out['wall_time']))
+
+
+def benchmark_throughput(models, dt, simulation_time, n_neurons=1000):
+    """Reports the simulated neuron steps per wall-clock second of unconnected neurons driven by a noisy current that
+    makes them spike regularly, so that all threshold and after-spike current dynamics are exercised"""
+    n_steps = n_neurons * int(round(simulation_time / dt))
+    print('{:<24} {:>14} {:>10}'.format('model', 'steps/s', 'n_spikes'))
+    for model in models:
+        nest.ResetKernel()
+        nest.SetKernelStatus({'resolution': dt})
+        neurons = nest.Create(model, n_neurons)
+        noise = nest.Create('noise_generator', params={'mean': 300.0, 'std': 100.0, 'dt': 1.0})
+        nest.Connect(noise, neurons)
+        spikedetector = nest.Create('spike_detector')
+        nest.Connect(neurons, spikedetector)
+
+        start = time.time()
+        nest.Simulate(simulation_time)
+        wall_time = time.time() - start
+
+        n_spikes = nest.GetStatus(spikedetector, 'n_events')[0]
+        print('{:<24} {:>14.0f} {:>10d}'.format(model, n_steps / wall_time, n_spikes))
+
+
+def benchmark_parameter_sharing(models, dt, simulation_time, n_neurons=1000000, n_parameter_sets=100):
+    """Reports the resident memory per neuron after creating n_neurons neurons with n_parameter_sets distinct parameter
+    sets, and the simulated neuron steps per second of these neurons under noisy current input"""
+    n_steps = n_neurons * int(round(simulation_time / dt))
+    print('{:<24} {:>10} {:>14} {:>14}'.format('model', 'n_sets', 'bytes/neuron', 'steps/s'))
+    for model in models:
+        nest.ResetKernel()
+        nest.SetKernelStatus({'resolution': dt})
+        mem_start = resident_memory()
+        neurons = nest.Create(model, n_neurons)
+        # replicate the parameter sets the way networks built from the Cell Types DB do, by varying C_m
+        C_m = nest.GetStatus(neurons[:1], 'C_m')[0]
+        nest.SetStatus(neurons, [{'C_m': C_m * (1.0 + 0.001 * (i % n_parameter_sets))} for i in range(n_neurons)])
+        nest.Simulate(dt)  # calibrates all neurons
+        mem_used = (resident_memory() - mem_start) * 1024.0
+
+        noise = nest.Create('noise_generator', params={'mean': 300.0, 'std': 100.0, 'dt': 1.0})
+        nest.Connect(noise, neurons)
+        start = time.time()
+        nest.Simulate(simulation_time)
+        wall_time = time.time() - start
+        print('{:<24} {:>10d} {:>14.0f} {:>14.0f}'.format(model, n_parameter_sets, mem_used / n_neurons,
+                                                          n_steps / wall_time))
+
+
+def benchmark_population(models, dt, simulation_time, sizes=(100, 1000, 10000, 100000), rate=5000.0):
+    """Reports the simulated neuron steps per second of each population model against its single-neuron model, i.e.
+    N neurons updated together against N separate nodes, under poisson input of the same seed"""
+    print('{:<24} {:>8} {:>14} {:>14} {:>9} {:>10}'.format(
+        'model', 'N', 'nodes steps/s', 'pop. steps/s', 'speed-up', 'count diff'))
+    for model in models:
+        single_model = model[:-len('_population')]
+        for n_neurons in sizes:
+            n_steps = n_neurons * int(round(simulation_time / dt))
+            wall_times = []
+            n_spikes = []
+            for m in [single_model, model]:
+                nest.ResetKernel()
+                nest.SetKernelStatus({'resolution': dt, 'grng_seed': 1234, 'rng_seeds': [1235]})
+                neurons = nest.Create(m, n_neurons)
+                noise = nest.Create('poisson_generator', params={'rate': rate})
+                nest.Connect(noise, neurons, syn_spec={'weight': 20.0, 'receptor_type': 1})
+                spikedetector = nest.Create('spike_detector')
+                nest.Connect(neurons, spikedetector)
+                nest.Simulate(dt)  # calibrates all neurons
+
+                start = time.time()
+                nest.Simulate(simulation_time)
+                wall_times.append(time.time() - start)
+                n_spikes.append(nest.GetStatus(spikedetector, 'n_events')[0])
+            print('{:<24} {:>8d} {:>14.0f} {:>14.0f} {:>9.1f} {:>10d}'.format(
+                model, n_neurons, n_steps / wall_times[0], n_steps / wall_times[1], wall_times[0] / wall_times[1],
+                abs(n_spikes[1] - n_spikes[0])))
+
+
+default_perf_events = 'L1-dcache-loads,L1-dcache-load-misses,l2_rqsts.references,l2_rqsts.miss'
+perf_events = default_perf_events
+
+
+def perf_stat(fn, events):
+    """Calls fn while 'perf stat' is attached to this process and returns a dictionary of event: count, which is
+    empty if perf is not available or an event is not supported"""
+    try:
+        perf = subprocess.Popen(['perf', 'stat', '-x', ',', '-e', events, '-p', str(os.getpid())],
+                                stderr=subprocess.PIPE, universal_newlines=True)
+    except OSError:
+        fn()
+        return {}
+    time.sleep(0.5)  # let perf attach
+    fn()
+    perf.send_signal(signal.SIGINT)
+    _, output = perf.communicate()
+    counts = {}
+    for line in output.splitlines():
+        fields = line.split(',')
+        if len(fields) > 2 and fields[0].strip().isdigit():
+            counts[fields[2]] = int(fields[0])
+    return counts
+
+
+def benchmark_cache(models, dt, simulation_time, n_neurons=100000, indegree=100, rate=5000.0):
+    """Reports the L1 and L2 data cache miss rates and the simulated neuron steps per second of a network of n_neurons
+    neurons with indegree random recurrent connections each and poisson input"""
+    n_steps = n_neurons * int(round(simulation_time / dt))
+    print('{:<24} {:>14} {:>10} {:>10}'.format('model', 'steps/s', 'L1 miss', 'L2 miss'))
+    for model in models:
+        nest.ResetKernel()
+        nest.SetKernelStatus({'resolution': dt})
+        neurons = nest.Create(model, n_neurons)
+        receptor_type = 1 if model.endswith('_psc') or model.endswith('_cond') else 0
+        noise = nest.Create('poisson_generator', params={'rate': rate})
+        nest.Connect(noise, neurons, syn_spec={'weight': 20.0, 'receptor_type': receptor_type})
+        nest.Connect(neurons, neurons, {'rule': 'fixed_indegree', 'indegree': indegree},
+                     {'weight': 1.0, 'delay': 1.0, 'receptor_type': receptor_type})
+        nest.Simulate(dt)  # calibrates all neurons
+
+        start = time.time()
+        counts = perf_stat(lambda: nest.Simulate(simulation_time), perf_events)
+        wall_time = time.time() - start
+
+        def miss_rate(misses, references):
+            if misses in counts and counts.get(references, 0) > 0:
+                return '{:.2%}'.format(float(counts[misses]) / counts[references])
+            return 'n/a'
+
+        print('{:<24} {:>14.0f} {:>10} {:>10}'.format(model, n_steps / wall_time,
+                                                      miss_rate('L1-dcache-load-misses', 'L1-dcache-loads'),
+                                                      miss_rate('l2_rqsts.miss', 'l2_rqsts.references')))
+
+
+# benchmark name: (benchmark function, default models)
+benchmarks = {
+    'cond-methods': (benchmark_cond_methods, cond_models),
+    'cond-solvers': (benchmark_cond_solvers, cond_models),
+    'cond-tolerances': (benchmark_cond_tolerances, cond_models),
+    'cond-memory': (benchmark_cond_memory, cond_models),
+    'quiescence': (benchmark_quiescence, all_models),
+    'event-driven': (benchmark_event_driven, ['glif_lif', 'glif_lif_r', 'glif_lif_asc', 'glif_lif_r_asc']),
+    'throughput': (benchmark_throughput, all_models),
+    'parameter-sharing': (benchmark_parameter_sharing, ['glif_lif_r_asc_a', 'glif_lif_r_asc_a_psc', 'glif_lif_r_asc_a_cond']),
+    'cache': (benchmark_cache, ['glif_lif_r_asc_a_psc']),
+    'population': (benchmark_population, ['glif_lif_psc_population']),
+    'precise-timing': (benchmark_precise_timing, ps_models),
+    'spike-time-methods': (benchmark_spike_time_methods, all_models[:10]),
+    'substeps': (benchmark_substeps, all_models[:10]),
+}
+
+if __name__ == '__main__':
+    parser = OptionParser()
+    parser.add_option("-b", "--benchmark", dest="benchmark", default="cond-methods", help="Name of benchmark to run.")
+    parser.add_option("-m", "--models", dest="models", default="", help="comma separated list of models to run.")
+    parser.add_option("--dt", dest="dt", type="float", default=0.005, help="simulation resolution in ms.")
+    parser.add_option("-t", "--time", dest="time", type="float", default=1000.0, help="simulated time in ms.")
+    parser.add_option("--perf-events", dest="perf_events", default=default_perf_events,
+                      help="comma separated list of perf events counted by the cache benchmark.")
+    parser.add_option("--list-benchmarks", action="store_true", dest="list_benchmarks", default=False,
+                      help="List all available benchmarks.")
+    options, args = parser.parse_args()
+
+    if options.list_benchmarks:
+        print(benchmarks.keys())
+        exit()
+
+    perf_events = options.perf_events
+    benchmark_fn, default_models = benchmarks[options.benchmark]
+    models = options.models.split(',') if options.models else default_models
+    benchmark_fn(models, options.dt, options.time)
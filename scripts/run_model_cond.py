@@ -38,7 +38,7 @@ def create_lif(config):
                                't_ref': config['spike_cut_length'] * config['dt'] * 1.0e03,
                                'V_reset': config['El_reference'] * 1.0e03,
                                #'V_dynamics_method': config['voltage_dynamics_method']['name']}) #'linear_forward_euler' or 'linear_exact'
-                               'V_dynamics_method': 'linear_exact'}) #'linear_forward_euler' or 'linear_exact'
+                               'V_dynamics_method': 'gsl_rkf45'}) #'gsl_rkf45' or 'exponential_integrator'
 
 def create_lif_asc(config):
     """Creates a nest glif_lif_asc object"""
@@ -55,7 +55,7 @@ def create_lif_asc(config):
                                'asc_amps': np.array(config['asc_amp_array']) *
                                            np.array(coeffs['asc_amp_array']) * 1.0e12,
                                #'V_dynamics_method': config['voltage_dynamics_method']['name']}) #'linear_forward_euler' or 'linear_exact'
-                               'V_dynamics_method': 'linear_exact'})
+                               'V_dynamics_method': 'gsl_rkf45'})
     
 def create_lif_r(config):
     """Creates a nest glif_lif_r object"""
@@ -73,7 +73,7 @@ def create_lif_r(config):
                                'a_reset': reset_params['a'], 
                                'b_reset': reset_params['b'] * 1.0e03,
                                #'V_dynamics_method': config['voltage_dynamics_method']['name']}) #'linear_forward_euler' or 'linear_exact'
-                               'V_dynamics_method': 'linear_exact'})  
+                               'V_dynamics_method': 'gsl_rkf45'})  
     
 def create_lif_r_asc(config):
     """Creates a nest glif_lif_r_asc object"""
@@ -95,7 +95,7 @@ def create_lif_r_asc(config):
                                'asc_amps': np.array(config['asc_amp_array']) *
                                            np.array(coeffs['asc_amp_array']) * 1.0e12,
                                #'V_dynamics_method': config['voltage_dynamics_method']['name']}) #'linear_forward_euler' or 'linear_exact'
-                               'V_dynamics_method': 'linear_exact'})
+                               'V_dynamics_method': 'gsl_rkf45'})
 
 def create_lif_r_asc_a(config):
     """Creates a nest glif_lif_r_asc_a object"""
@@ -120,7 +120,7 @@ def create_lif_r_asc_a(config):
                                'asc_amps': np.array(config['asc_amp_array']) *
                                            np.array(coeffs['asc_amp_array']) * 1.0e12,
                                #'V_dynamics_method': config['voltage_dynamics_method']['name']}) #'linear_forward_euler' or 'linear_exact'
-                               'V_dynamics_method': 'linear_exact'})
+                               'V_dynamics_method': 'gsl_rkf45'})
 
 ## Create model with synaptic ports
 def create_lif_cond(config, syn_tau, E_rev):